@@ -0,0 +1,316 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Companion to interface.cpp — "find every swimmer" without dynamic_cast.
+//
+// Build: g++ -std=c++17 -O2 animal-capability-store.cpp -o capability-store
+// Run:   ./capability-store [animalCount]   (default 10,000,000)
+
+//
+// =======================================================
+// 1. THE PROBLEM WITH PER-OBJECT DISPATCH
+// =======================================================
+//
+// With segregated interfaces, "make every swimmer swim" looks like:
+//
+//     for (Walkable *w : animals)
+//       if (auto *s = dynamic_cast<Swimmable *>(w)) s->swim();
+//
+// Per animal: a pointer chase to the heap, an RTTI walk (slow for
+// cross-casts), a failed branch for non-swimmers, a virtual call.
+//
+// An ENTITY-COMPONENT style store flips it around:
+//   - each animal is just an id + a CAPABILITY BITMASK
+//   - each capability owns a DENSE ARRAY of the animals that have it
+//   - forEachSwimmer() walks the swim array front to back
+// Non-swimmers cost nothing; the hardware prefetcher does the rest.
+
+//
+// =======================================================
+// 2. CLASSIC HIERARCHY (baseline, as in interface.cpp)
+// =======================================================
+//
+// swim()/walk()/fly() advance a distance instead of printing, so the
+// benchmark measures dispatch, not std::cout.
+
+class Walkable {
+public:
+  virtual ~Walkable() {}
+  virtual void walk() = 0;
+};
+
+class Flyable {
+public:
+  virtual ~Flyable() {}
+  virtual void fly() = 0;
+};
+
+class Swimmable {
+public:
+  virtual ~Swimmable() {}
+  virtual void swim() = 0;
+};
+
+class Dog : public Walkable, public Swimmable {
+public:
+  float speed = 1.0f, distance = 0.0f;
+  void walk() override { distance += speed; }
+  void swim() override { distance += speed * 0.5f; }
+};
+
+class Duck : public Walkable, public Flyable, public Swimmable {
+public:
+  float speed = 1.0f, distance = 0.0f;
+  void walk() override { distance += speed * 0.5f; }
+  void fly() override { distance += speed * 4.0f; }
+  void swim() override { distance += speed; }
+};
+
+class Cat : public Walkable {
+public:
+  float speed = 1.0f, distance = 0.0f;
+  void walk() override { distance += speed; }
+};
+
+//
+// =======================================================
+// 3. CAPABILITY BITMASK + DENSE COMPONENT ARRAYS
+// =======================================================
+//
+
+using Entity = std::uint32_t;
+
+enum Capability : std::uint8_t {
+  kWalk = 1u << 0,
+  kFly = 1u << 1,
+  kSwim = 1u << 2,
+};
+
+// Per-capability payload. Tightly packed: 12 bytes per animal.
+struct Motion {
+  Entity entity;
+  float speed;
+  float distance;
+};
+
+// "Sparse set": dense array for iteration + entity -> slot for O(1)
+// add/remove. Removal swaps the last element into the hole.
+class CapabilityArray {
+private:
+  static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+  std::vector<Motion> dense_;
+  std::vector<std::uint32_t> slot_; // indexed by entity
+
+public:
+  void add(Entity e, float speed) {
+    if (slot_.size() <= e) {
+      slot_.resize(e + 1, kNone);
+    }
+    if (slot_[e] != kNone) {
+      return;
+    }
+    slot_[e] = std::uint32_t(dense_.size());
+    dense_.push_back({e, speed, 0.0f});
+  }
+
+  void remove(Entity e) {
+    if (e >= slot_.size() || slot_[e] == kNone) {
+      return;
+    }
+    std::uint32_t hole = slot_[e];
+    dense_[hole] = dense_.back();
+    slot_[dense_[hole].entity] = hole;
+    dense_.pop_back();
+    slot_[e] = kNone;
+  }
+
+  Motion *find(Entity e) {
+    return e < slot_.size() && slot_[e] != kNone ? &dense_[slot_[e]]
+                                                 : nullptr;
+  }
+
+  std::size_t size() const { return dense_.size(); }
+  std::vector<Motion> &items() { return dense_; }
+};
+
+class AnimalStore {
+private:
+  std::vector<std::string> names_;
+  std::vector<std::uint8_t> masks_;
+  CapabilityArray walkers_, flyers_, swimmers_;
+
+  CapabilityArray &arrayFor(Capability cap) {
+    switch (cap) {
+    case kWalk: return walkers_;
+    case kFly:  return flyers_;
+    case kSwim: return swimmers_;
+    }
+    return walkers_; // defensive
+  }
+
+public:
+  void reserve(std::size_t n) {
+    names_.reserve(n);
+    masks_.reserve(n);
+  }
+
+  Entity spawn(const std::string &name, std::uint8_t mask, float speed) {
+    auto e = Entity(masks_.size());
+    names_.push_back(name);
+    masks_.push_back(0);
+    for (Capability cap : {kWalk, kFly, kSwim}) {
+      if (mask & cap) {
+        grant(e, cap, speed);
+      }
+    }
+    return e;
+  }
+
+  // Capabilities can change at runtime — impossible with inheritance
+  void grant(Entity e, Capability cap, float speed) {
+    masks_[e] |= cap;
+    arrayFor(cap).add(e, speed);
+  }
+
+  void revoke(Entity e, Capability cap) {
+    masks_[e] &= std::uint8_t(~cap);
+    arrayFor(cap).remove(e);
+  }
+
+  bool has(Entity e, Capability cap) const { return masks_[e] & cap; }
+  const std::string &name(Entity e) const { return names_[e]; }
+  std::size_t swimmerCount() const { return swimmers_.size(); }
+
+  float distance(Entity e, Capability cap) {
+    Motion *m = arrayFor(cap).find(e);
+    return m != nullptr ? m->distance : 0.0f;
+  }
+
+  template <typename Fn> void forEachWalker(Fn fn) {
+    for (Motion &m : walkers_.items()) {
+      fn(m);
+    }
+  }
+
+  template <typename Fn> void forEachFlyer(Fn fn) {
+    for (Motion &m : flyers_.items()) {
+      fn(m);
+    }
+  }
+
+  template <typename Fn> void forEachSwimmer(Fn fn) {
+    for (Motion &m : swimmers_.items()) {
+      fn(m);
+    }
+  }
+};
+
+//
+// =======================================================
+// 4. BENCHMARK: dynamic_cast FILTER vs forEachSwimmer
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+void benchmark(std::size_t count) {
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<int> kind(0, 2);
+
+  std::vector<std::unique_ptr<Walkable>> animals;
+  animals.reserve(count);
+  AnimalStore store;
+  store.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    switch (kind(rng)) {
+    case 0:
+      animals.push_back(std::make_unique<Dog>());
+      store.spawn("Dog", kWalk | kSwim, 1.0f);
+      break;
+    case 1:
+      animals.push_back(std::make_unique<Duck>());
+      store.spawn("Duck", kWalk | kFly | kSwim, 1.0f);
+      break;
+    default:
+      animals.push_back(std::make_unique<Cat>());
+      store.spawn("Cat", kWalk, 1.0f);
+      break;
+    }
+  }
+
+  const int passes = 3;
+  std::size_t castHits = 0;
+  auto start = Clock::now();
+  for (int p = 0; p < passes; ++p) {
+    for (const auto &a : animals) {
+      if (auto *s = dynamic_cast<Swimmable *>(a.get())) {
+        s->swim();
+        ++castHits;
+      }
+    }
+  }
+  double castMs = millisSince(start) / passes;
+
+  std::size_t storeHits = 0;
+  start = Clock::now();
+  for (int p = 0; p < passes; ++p) {
+    store.forEachSwimmer([&](Motion &m) {
+      m.distance += m.speed;
+      ++storeHits;
+    });
+  }
+  double storeMs = millisSince(start) / passes;
+
+  std::cout << "Swimmers: " << castHits / passes << " of " << count << "\n";
+  std::cout << "dynamic_cast filter: " << castMs << " ms/pass\n";
+  std::cout << "forEachSwimmer:      " << storeMs << " ms/pass ("
+            << storeHits / passes << " visited)\n";
+  std::cout << "Speed-up: " << castMs / storeMs << "x\n";
+}
+
+//
+// =======================================================
+// 5. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Capability Store Demo ===\n\n";
+
+  AnimalStore zoo;
+  Entity dog = zoo.spawn("🐕 Dog", kWalk | kSwim, 2.0f);
+  Entity duck = zoo.spawn("🦆 Duck", kWalk | kFly | kSwim, 1.0f);
+  Entity cat = zoo.spawn("🐈 Cat", kWalk, 1.5f);
+
+  zoo.forEachSwimmer([&](Motion &m) {
+    m.distance += m.speed;
+    std::cout << zoo.name(m.entity) << " is swimming\n";
+  });
+
+  // A capability is data, so it can change while the program runs
+  zoo.revoke(dog, kSwim);
+  zoo.grant(cat, kSwim, 0.5f);
+  std::cout << "\nAfter revoke(dog, swim) + grant(cat, swim):\n";
+  zoo.forEachSwimmer([&](Motion &m) {
+    std::cout << zoo.name(m.entity) << " is swimming\n";
+  });
+  std::cout << "Duck can fly? " << (zoo.has(duck, kFly) ? "yes" : "no")
+            << ", swum " << zoo.distance(duck, kSwim) << "\n";
+
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 10000000;
+  std::cout << "\n=== Benchmark (" << count << " animals) ===\n";
+  benchmark(count);
+
+  return 0;
+}
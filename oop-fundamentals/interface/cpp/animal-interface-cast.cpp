@@ -0,0 +1,308 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Companion to interface.cpp — cross-casting between interfaces in O(1),
+// without RTTI.
+//
+// Build: g++ -std=c++17 -O2 animal-interface-cast.cpp -o interface-cast
+//        (as<>() alone also builds with -fno-rtti; the dynamic_cast
+//         baseline needs RTTI, so compile with -DNO_RTTI_BASELINE to drop it)
+// Run:   ./interface-cast [animalCount]   (default 10,000,000)
+
+//
+// =======================================================
+// 1. WHAT IS A CROSS-CAST?
+// =======================================================
+//
+//     Walkable *w = &dog;
+//     Swimmable *s = dynamic_cast<Swimmable *>(w);   // sideways!
+//
+// Walkable and Swimmable are unrelated bases of Dog, so the compiler
+// cannot compute the pointer adjustment statically. dynamic_cast finds
+// the complete object through RTTI, then SEARCHES the class hierarchy
+// for a Swimmable base — string/type_info comparisons on a slow path.
+//
+// Idea: every class publishes a tiny CAST TABLE:
+//
+//     interface id  ->  byte offset of that base inside the object
+//
+// as<Swimmable>(w) = one virtual call to fetch the table + two loads
+// + pointer arithmetic. Missing interface -> sentinel -> nullptr.
+
+//
+// =======================================================
+// 2. INTERFACE IDS + CAST TABLE
+// =======================================================
+//
+
+enum class InterfaceId : std::size_t {
+  Walkable,
+  Flyable,
+  Swimmable,
+  Printable,
+  Serializable,
+  Count
+};
+
+constexpr std::size_t kInterfaceCount = std::size_t(InterfaceId::Count);
+constexpr std::ptrdiff_t kAbsent = -1;
+
+struct CastTable {
+  std::ptrdiff_t offset[kInterfaceCount]; // from the complete object
+};
+
+// Every interface derives from this. A concrete class implements
+// castTable() ONCE and that single override serves all of its bases.
+class Castable {
+public:
+  virtual const CastTable &castTable() const = 0;
+
+protected:
+  ~Castable() {} // never deleted through Castable*
+};
+
+// Byte offsets of each base inside `object`. They are read off a LIVE
+// object: a derived-to-base static_cast on storage where no Derived
+// was constructed is undefined behaviour, even though the adjustment
+// is fixed for non-virtual inheritance.
+template <typename Derived, typename... Interfaces>
+CastTable buildCastTable(const Derived &object) {
+  CastTable table;
+  for (auto &o : table.offset) {
+    o = kAbsent;
+  }
+  auto *complete = reinterpret_cast<const unsigned char *>(&object);
+  ((table.offset[std::size_t(Interfaces::kId)] =
+        reinterpret_cast<const unsigned char *>(
+            static_cast<const Interfaces *>(&object)) -
+        complete),
+   ...);
+  return table;
+}
+
+// The RTTI-free cross-cast
+template <typename To, typename From> To *as(From *from) {
+  if (from == nullptr) {
+    return nullptr;
+  }
+  const CastTable &table = from->castTable();
+  std::ptrdiff_t to = table.offset[std::size_t(To::kId)];
+  if (to == kAbsent) {
+    return nullptr;
+  }
+  auto *complete = reinterpret_cast<unsigned char *>(from) -
+                   table.offset[std::size_t(From::kId)];
+  return reinterpret_cast<To *>(complete + to);
+}
+
+//
+// =======================================================
+// 3. INTERFACES FROM interface.cpp (+ an id each)
+// =======================================================
+//
+
+class Walkable : public Castable {
+public:
+  static constexpr InterfaceId kId = InterfaceId::Walkable;
+  virtual ~Walkable() {}
+  virtual void walk() = 0;
+};
+
+class Flyable : public Castable {
+public:
+  static constexpr InterfaceId kId = InterfaceId::Flyable;
+  virtual ~Flyable() {}
+  virtual void fly() = 0;
+};
+
+class Swimmable : public Castable {
+public:
+  static constexpr InterfaceId kId = InterfaceId::Swimmable;
+  virtual ~Swimmable() {}
+  virtual void swim() = 0;
+};
+
+class Printable : public Castable {
+public:
+  static constexpr InterfaceId kId = InterfaceId::Printable;
+  virtual ~Printable() {}
+  virtual void print() const = 0;
+};
+
+class Serializable : public Castable {
+public:
+  static constexpr InterfaceId kId = InterfaceId::Serializable;
+  virtual ~Serializable() {}
+  virtual std::string serialize() const = 0;
+};
+
+//
+// =======================================================
+// 4. CONCRETE CLASSES PUBLISH THEIR TABLE
+// =======================================================
+//
+// swim()/walk()/fly() count instead of printing so the benchmark
+// measures the cast, not std::cout.
+
+class Dog : public Walkable, public Swimmable {
+public:
+  int steps = 0;
+
+  // Built from the first object asked, then shared by the class
+  const CastTable &castTable() const override {
+    static const CastTable table =
+        buildCastTable<Dog, Walkable, Swimmable>(*this);
+    return table;
+  }
+  void walk() override { ++steps; }
+  void swim() override { ++steps; }
+};
+
+class Duck : public Walkable, public Flyable, public Swimmable {
+public:
+  int steps = 0;
+
+  const CastTable &castTable() const override {
+    static const CastTable table =
+        buildCastTable<Duck, Walkable, Flyable, Swimmable>(*this);
+    return table;
+  }
+  void walk() override { ++steps; }
+  void fly() override { ++steps; }
+  void swim() override { ++steps; }
+};
+
+class Cat : public Walkable {
+public:
+  int steps = 0;
+
+  const CastTable &castTable() const override {
+    static const CastTable table = buildCastTable<Cat, Walkable>(*this);
+    return table;
+  }
+  void walk() override { ++steps; }
+};
+
+class Document : public Printable, public Serializable {
+private:
+  std::string content_;
+
+public:
+  explicit Document(const std::string &content) : content_(content) {}
+
+  const CastTable &castTable() const override {
+    static const CastTable table =
+        buildCastTable<Document, Printable, Serializable>(*this);
+    return table;
+  }
+  void print() const override {
+    std::cout << "📄 Document: " << content_ << "\n";
+  }
+  std::string serialize() const override {
+    return "{\"content\":\"" + content_ + "\"}";
+  }
+};
+
+//
+// =======================================================
+// 5. BENCHMARK: as<> vs dynamic_cast
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+void benchmark(std::size_t count) {
+  std::mt19937 rng(21);
+  std::uniform_int_distribution<int> kind(0, 2);
+  std::vector<std::unique_ptr<Walkable>> owned;
+  std::vector<Walkable *> animals;
+  owned.reserve(count);
+  animals.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    switch (kind(rng)) {
+    case 0: owned.push_back(std::make_unique<Dog>()); break;
+    case 1: owned.push_back(std::make_unique<Duck>()); break;
+    default: owned.push_back(std::make_unique<Cat>()); break;
+    }
+    animals.push_back(owned.back().get());
+  }
+
+  std::size_t hits = 0;
+  auto start = Clock::now();
+  for (Walkable *w : animals) {
+    if (Swimmable *s = as<Swimmable>(w)) {
+      s->swim();
+      ++hits;
+    }
+  }
+  double tableMs = millisSince(start);
+  std::cout << "as<Swimmable>:           " << tableMs << " ms ("
+            << tableMs * 1e6 / double(count) << " ns/cast, " << hits
+            << " swimmers)\n";
+
+#if !defined(NO_RTTI_BASELINE)
+  hits = 0;
+  start = Clock::now();
+  for (Walkable *w : animals) {
+    if (auto *s = dynamic_cast<Swimmable *>(w)) {
+      s->swim();
+      ++hits;
+    }
+  }
+  double rttiMs = millisSince(start);
+  std::cout << "dynamic_cast<Swimmable>: " << rttiMs << " ms ("
+            << rttiMs * 1e6 / double(count) << " ns/cast, " << hits
+            << " swimmers)\n";
+  std::cout << "Speed-up: " << rttiMs / tableMs << "x\n";
+#endif
+}
+
+//
+// =======================================================
+// 6. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== RTTI-free Interface Cast Demo ===\n\n";
+
+  Dog dog;
+  Duck duck;
+  Cat cat;
+  std::vector<Walkable *> walkers = {&dog, &duck, &cat};
+  for (Walkable *w : walkers) {
+    Swimmable *s = as<Swimmable>(w);
+    Flyable *f = as<Flyable>(w);
+    std::cout << "swims: " << (s ? "yes" : "no ")
+              << "  flies: " << (f ? "yes" : "no ") << "\n";
+  }
+
+  // Cast from a non-primary base: offsets must be adjusted correctly
+  Flyable *flyer = &duck;
+  Swimmable *viaTable = as<Swimmable>(flyer);
+  std::cout << "Duck Flyable* -> Swimmable* matches static_cast: "
+            << (viaTable == static_cast<Swimmable *>(&duck) ? "yes" : "no")
+            << "\n";
+
+  Document doc("Hello, World!");
+  Printable *printable = &doc;
+  if (Serializable *ser = as<Serializable>(printable)) {
+    std::cout << "Serialized via as<>: " << ser->serialize() << "\n";
+  }
+
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 10000000;
+  std::cout << "\n=== Benchmark (" << count << " animals) ===\n";
+  benchmark(count);
+
+  return 0;
+}
@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Companion to interface.cpp — flat latency when a gateway is overloaded.
+//
+// Build: g++ -std=c++17 -O2 -pthread payment-adaptive-concurrency.cpp -o adapt
+// Run:   ./adapt
+
+//
+// =======================================================
+// 1. WHY A FIXED LIMIT FAILS
+// =======================================================
+//
+// A gateway can only work on so many payments at once. Send more and
+// the extra requests just QUEUE inside it: throughput stays the same,
+// but every request now waits behind the queue. A fixed pool of 64
+// threads will happily keep 64 requests in flight against a provider
+// that can serve 8, and under overload the backlog (and latency) grows
+// without bound.
+//
+// TCP solved the same problem for networks. Vegas-style control:
+//
+//     minRtt  = best round trip seen (no queueing)
+//     queue   = limit * (1 - minRtt / rtt)   // requests waiting
+//     queue < alpha  ->  limit grows         // spare capacity
+//     queue > beta   ->  limit shrinks       // we are building a queue
+//
+// The limit settles near the gateway's real capacity. Requests beyond
+// it are REROUTED to another provider or SHED (fail fast, retry later)
+// instead of queueing.
+
+//
+// =======================================================
+// 2. GATEWAY INTERFACE + A CAPACITY-LIMITED STAND-IN
+// =======================================================
+//
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual void initiatePayment(double amount) = 0;
+  virtual std::string getProviderName() const = 0;
+};
+
+// `slots` payments in parallel, ~serviceTime each; the rest wait FIFO
+class SimulatedGateway : public PaymentGateway {
+private:
+  std::string name_;
+  std::mutex mutex_;
+  std::condition_variable freed_;
+  int free_;
+  std::chrono::microseconds service_;
+
+public:
+  SimulatedGateway(const std::string &name, int slots,
+                   std::chrono::microseconds service)
+      : name_(name), free_(slots), service_(service) {}
+
+  void initiatePayment(double) override {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      freed_.wait(lock, [this] { return free_ > 0; });
+      --free_;
+    }
+    thread_local std::mt19937 rng(std::random_device{}());
+    std::uniform_real_distribution<double> jitter(0.8, 1.2);
+    std::this_thread::sleep_for(std::chrono::microseconds(
+        long(double(service_.count()) * jitter(rng))));
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++free_;
+    }
+    freed_.notify_one();
+  }
+
+  std::string getProviderName() const override { return name_; }
+};
+
+//
+// =======================================================
+// 3. VEGAS-STYLE CONCURRENCY LIMITER
+// =======================================================
+//
+
+class ConcurrencyLimiter {
+private:
+  std::mutex mutex_;
+  bool adaptive_;
+  double limit_;
+  int inFlight_ = 0;
+  double minRttUs_ = std::numeric_limits<double>::infinity();
+  std::uint64_t samples_ = 0;
+
+  static constexpr double kMinLimit = 1, kMaxLimit = 256;
+
+public:
+  // adaptive = false gives a plain fixed cap (the baseline)
+  ConcurrencyLimiter(bool adaptive, double initialLimit)
+      : adaptive_(adaptive), limit_(initialLimit) {}
+
+  bool tryAcquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (inFlight_ >= int(limit_)) {
+      return false;
+    }
+    ++inFlight_;
+    return true;
+  }
+
+  void release(double rttUs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --inFlight_;
+    if (!adaptive_) {
+      return;
+    }
+    // Forget the minimum now and then, in case the gateway got faster
+    // or slower for good
+    if (++samples_ % 1000 == 0) {
+      minRttUs_ = rttUs;
+    }
+    minRttUs_ = std::min(minRttUs_, rttUs);
+
+    double queue = limit_ * (1.0 - minRttUs_ / rttUs);
+    double step = std::max(1.0, std::log10(limit_));
+    double alpha = 3 * step, beta = 6 * step;
+    if (queue < alpha) {
+      limit_ += step / limit_ * 4; // grow gently, ~per window of samples
+    } else if (queue > beta) {
+      limit_ -= step / limit_ * 8; // back off twice as fast
+    }
+    limit_ = std::clamp(limit_, kMinLimit, kMaxLimit);
+  }
+
+  double limit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limit_;
+  }
+};
+
+//
+// =======================================================
+// 4. CHECKOUT SERVICE: ADMIT, REROUTE OR SHED
+// =======================================================
+//
+
+enum class Outcome { Primary, Rerouted, Shed };
+
+class CheckoutService {
+private:
+  struct Route {
+    PaymentGateway *gateway;
+    ConcurrencyLimiter *limiter;
+  };
+
+  std::vector<Route> routes_; // in preference order
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> work_;
+  std::vector<std::thread> pool_;
+  bool stopping_ = false;
+
+public:
+  explicit CheckoutService(int threads) {
+    for (int i = 0; i < threads; ++i) {
+      pool_.emplace_back([this] {
+        while (true) {
+          std::function<void()> job;
+          {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return stopping_ || !work_.empty(); });
+            if (work_.empty()) {
+              return;
+            }
+            job = std::move(work_.front());
+            work_.pop_front();
+          }
+          job();
+        }
+      });
+    }
+  }
+
+  ~CheckoutService() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    ready_.notify_all();
+    for (auto &t : pool_) {
+      t.join();
+    }
+  }
+
+  void addGateway(PaymentGateway &gateway, ConcurrencyLimiter &limiter) {
+    routes_.push_back({&gateway, &limiter});
+  }
+
+  // Non-blocking: admits to the first gateway with headroom, or sheds.
+  // onDone runs on a pool thread when the payment finishes.
+  Outcome processCheckout(double amount, std::function<void()> onDone) {
+    for (std::size_t i = 0; i < routes_.size(); ++i) {
+      Route route = routes_[i];
+      if (!route.limiter->tryAcquire()) {
+        continue;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        work_.push_back([route, amount, onDone] {
+          auto start = std::chrono::steady_clock::now();
+          route.gateway->initiatePayment(amount);
+          route.limiter->release(
+              std::chrono::duration<double, std::micro>(
+                  std::chrono::steady_clock::now() - start)
+                  .count());
+          onDone();
+        });
+      }
+      ready_.notify_one();
+      return i == 0 ? Outcome::Primary : Outcome::Rerouted;
+    }
+    return Outcome::Shed;
+  }
+};
+
+//
+// =======================================================
+// 5. BENCHMARK: NORMAL LOAD, THEN 2x OVERLOAD
+// =======================================================
+//
+// Each gateway: 8 slots x ~2 ms = ~4,000 payments/s. Open-loop
+// arrivals at 2,000/s for 1 s, then 8,000/s for 3 s. Latency is
+// measured from arrival, for admitted checkouts only.
+
+using Clock = std::chrono::steady_clock;
+
+struct PhaseStats {
+  std::mutex mutex;
+  std::vector<double> latencyMs;
+  std::atomic<int> shed{0}, rerouted{0};
+
+  void record(double ms) {
+    std::lock_guard<std::mutex> lock(mutex);
+    latencyMs.push_back(ms);
+  }
+
+  void print(const char *phase) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::sort(latencyMs.begin(), latencyMs.end());
+    auto pct = [&](double p) {
+      return latencyMs.empty()
+                 ? 0.0
+                 : latencyMs[std::min(latencyMs.size() - 1,
+                                      std::size_t(p * double(
+                                                          latencyMs.size())))];
+    };
+    std::printf("  %-9s served %6zu  p50 %7.1f ms  p99 %7.1f ms  "
+                "rerouted %5d  shed %5d\n",
+                phase, latencyMs.size(), pct(0.50), pct(0.99),
+                rerouted.load(), shed.load());
+  }
+};
+
+void runScenario(const char *label, bool adaptive, bool withBackup) {
+  using std::chrono::microseconds;
+  SimulatedGateway stripe("Stripe", 8, microseconds(2000));
+  SimulatedGateway paypal("PayPal", 8, microseconds(2000));
+  // Baseline: no admission limit at all; the 64-thread pool's queue
+  // absorbs whatever the gateway cannot
+  const double initial = adaptive ? 20 : std::numeric_limits<int>::max();
+  ConcurrencyLimiter stripeLimit(adaptive, initial);
+  ConcurrencyLimiter paypalLimit(adaptive, initial);
+
+  PhaseStats normal, overload;
+  {
+    CheckoutService service(64);
+    service.addGateway(stripe, stripeLimit);
+    if (withBackup) {
+      service.addGateway(paypal, paypalLimit);
+    }
+
+    struct Phase {
+      PhaseStats *stats;
+      double rate;
+      std::chrono::milliseconds length;
+    };
+    auto next = Clock::now();
+    for (Phase phase : {Phase{&normal, 2000, std::chrono::milliseconds(1000)},
+                        Phase{&overload, 8000,
+                              std::chrono::milliseconds(3000)}}) {
+      auto interval =
+          std::chrono::nanoseconds(std::int64_t(1e9 / phase.rate));
+      auto end = next + phase.length;
+      for (; next < end; next += interval) {
+        std::this_thread::sleep_until(next);
+        PhaseStats *stats = phase.stats;
+        auto arrived = next;
+        Outcome o = service.processCheckout(10.0, [stats, arrived] {
+          stats->record(std::chrono::duration<double, std::milli>(
+                            Clock::now() - arrived)
+                            .count());
+        });
+        if (o == Outcome::Shed) {
+          stats->shed.fetch_add(1);
+        } else if (o == Outcome::Rerouted) {
+          stats->rerouted.fetch_add(1);
+        }
+      }
+    }
+  } // drains the pool
+
+  std::cout << label;
+  if (adaptive) {
+    std::cout << " (final limit " << int(stripeLimit.limit()) << ")";
+  }
+  std::cout << "\n";
+  normal.print("normal:");
+  overload.print("overload:");
+}
+
+//
+// =======================================================
+// 6. DEMONSTRATION
+// =======================================================
+//
+
+int main() {
+  std::cout << "=== Adaptive Concurrency Limit Demo ===\n"
+            << "Gateway capacity 8 x 2 ms (~4k/s); 2k/s for 1 s, then "
+               "8k/s for 3 s\n\n";
+
+  runScenario("64 threads, no limit", false, false);
+  runScenario("Vegas limit, shed excess", true, false);
+  runScenario("Vegas limit, reroute to PayPal, then shed", true, true);
+
+  return 0;
+}
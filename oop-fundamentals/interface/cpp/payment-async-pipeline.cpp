@@ -0,0 +1,416 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Companion to interface.cpp — CheckoutService without the blocking call.
+//
+// Build: g++ -std=c++20 -O2 -pthread payment-async-pipeline.cpp -o pipeline
+// Run:   ./pipeline
+
+//
+// =======================================================
+// 1. WHY AN ASYNC PIPELINE?
+// =======================================================
+//
+// processCheckout() calls initiatePayment() and WAITS. If a gateway
+// round trip is 2 ms, one thread can do at most 500 checkouts/s, no
+// matter how fast the CPU is.
+//
+// Pipeline:
+//
+//   callers ──push──▶ [ MPSC queue ] ──▶ worker ──batch──▶ gateway
+//   (many threads)     one per provider   drains up to N     one round
+//                                         jobs at a time     trip per batch
+//
+//   - MPSC = Multi-Producer Single-Consumer: any thread may submit,
+//     only the provider's worker pops — so the queue can be lock-free
+//   - Batching amortises the round trip over up to N payments
+//   - Callers get the result via std::future or a callback
+
+//
+// =======================================================
+// 2. PAYMENT GATEWAY INTERFACE (+ batch entry point)
+// =======================================================
+//
+
+struct PaymentResult {
+  std::uint64_t id = 0;
+  double amount = 0;
+  bool approved = false;
+  std::string provider;
+};
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual void initiatePayment(double amount) = 0;
+  virtual std::string getProviderName() const = 0;
+
+  // Default: no real batching, one call per payment. Gateways with a
+  // batch API override this to pay one round trip for the whole batch.
+  virtual void initiateBatch(const double *amounts, std::size_t count,
+                             bool *approved) {
+    for (std::size_t i = 0; i < count; ++i) {
+      initiatePayment(amounts[i]);
+      approved[i] = true;
+    }
+  }
+};
+
+// Local stand-in for Stripe/Razorpay/PayPal: sleeps one simulated
+// network round trip per request (single or batched).
+class StandInGateway : public PaymentGateway {
+private:
+  std::string name_;
+  std::chrono::microseconds roundTrip_;
+
+public:
+  StandInGateway(const std::string &name, std::chrono::microseconds roundTrip)
+      : name_(name), roundTrip_(roundTrip) {}
+
+  void initiatePayment(double) override {
+    std::this_thread::sleep_for(roundTrip_);
+  }
+
+  std::string getProviderName() const override { return name_; }
+
+  void initiateBatch(const double *, std::size_t count,
+                     bool *approved) override {
+    std::this_thread::sleep_for(roundTrip_);
+    std::fill(approved, approved + count, true);
+  }
+};
+
+//
+// =======================================================
+// 3. LOCK-FREE MPSC QUEUE (intrusive, Vyukov-style)
+// =======================================================
+//
+// push(): one atomic exchange — wait-free for producers.
+// pop():  consumer-only; may briefly see nullptr while a producer is
+//         between its exchange and its link store.
+
+struct CheckoutJob {
+  std::atomic<CheckoutJob *> next{nullptr};
+  std::uint64_t id = 0;
+  double amount = 0;
+  std::function<void(const PaymentResult &)> callback; // or...
+  std::promise<PaymentResult> promise;                 // ...this
+};
+
+class MpscQueue {
+private:
+  std::atomic<CheckoutJob *> head_; // producers swap in here
+  CheckoutJob *tail_;               // consumer reads from here
+  CheckoutJob stub_;
+
+public:
+  MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+  void push(CheckoutJob *job) {
+    job->next.store(nullptr, std::memory_order_relaxed);
+    CheckoutJob *prev = head_.exchange(job, std::memory_order_acq_rel);
+    prev->next.store(job, std::memory_order_release);
+  }
+
+  CheckoutJob *pop() {
+    CheckoutJob *tail = tail_;
+    CheckoutJob *next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return nullptr;
+      }
+      tail_ = tail = next;
+      next = tail->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      return nullptr; // producer mid-push; try again shortly
+    }
+    push(&stub_); // re-insert stub so the last real job can be detached
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    return nullptr;
+  }
+};
+
+//
+// =======================================================
+// 4. PROVIDER WORKER: DRAIN, BATCH, COMPLETE
+// =======================================================
+//
+
+class ProviderWorker {
+private:
+  PaymentGateway &gateway_;
+  std::size_t maxBatch_;
+  MpscQueue queue_;
+  std::atomic<std::int64_t> pending_{0}; // also the wake-up word
+  std::atomic<bool> stopping_{false};
+  std::thread thread_;
+
+  void run() {
+    std::vector<CheckoutJob *> batch;
+    std::vector<double> amounts;
+    std::unique_ptr<bool[]> approved(new bool[maxBatch_]);
+    const std::string provider = gateway_.getProviderName();
+
+    while (true) {
+      batch.clear();
+      while (batch.size() < maxBatch_) {
+        CheckoutJob *job = queue_.pop();
+        if (job == nullptr) {
+          break;
+        }
+        batch.push_back(job);
+      }
+
+      if (batch.empty()) {
+        if (stopping_.load()) {
+          return;
+        }
+        if (pending_.load() == 0) {
+          pending_.wait(0); // sleep until a producer bumps the count
+        } else {
+          std::this_thread::yield(); // a push is mid-flight
+        }
+        continue;
+      }
+      pending_.fetch_sub(std::int64_t(batch.size()));
+
+      amounts.clear();
+      for (CheckoutJob *job : batch) {
+        amounts.push_back(job->amount);
+      }
+      gateway_.initiateBatch(amounts.data(), batch.size(), approved.get());
+
+      for (std::size_t i = 0; i < batch.size(); ++i) {
+        CheckoutJob *job = batch[i];
+        PaymentResult result{job->id, job->amount, approved[i], provider};
+        if (job->callback) {
+          job->callback(result);
+        } else {
+          job->promise.set_value(std::move(result));
+        }
+        delete job;
+      }
+    }
+  }
+
+public:
+  ProviderWorker(PaymentGateway &gateway, std::size_t maxBatch)
+      : gateway_(gateway), maxBatch_(maxBatch), thread_([this] { run(); }) {}
+
+  ~ProviderWorker() {
+    stopping_.store(true);
+    pending_.fetch_add(1); // wake the worker if it is asleep
+    pending_.notify_one();
+    thread_.join();
+  }
+
+  void submit(CheckoutJob *job) {
+    pending_.fetch_add(1);
+    queue_.push(job);
+    pending_.notify_one();
+  }
+};
+
+//
+// =======================================================
+// 5. ASYNC CHECKOUT SERVICE
+// =======================================================
+//
+
+class AsyncCheckoutService {
+private:
+  std::map<std::string, std::unique_ptr<ProviderWorker>> workers_;
+  std::atomic<std::uint64_t> nextId_{1};
+
+  CheckoutJob *makeJob(double amount) {
+    auto *job = new CheckoutJob;
+    job->id = nextId_.fetch_add(1, std::memory_order_relaxed);
+    job->amount = amount;
+    return job;
+  }
+
+  ProviderWorker *workerFor(const std::string &provider) {
+    auto it = workers_.find(provider);
+    return it == workers_.end() ? nullptr : it->second.get();
+  }
+
+public:
+  void addGateway(PaymentGateway &gateway, std::size_t maxBatch = 256) {
+    workers_[gateway.getProviderName()] =
+        std::make_unique<ProviderWorker>(gateway, maxBatch);
+  }
+
+  std::future<PaymentResult> processCheckout(const std::string &provider,
+                                             double amount) {
+    ProviderWorker *worker = workerFor(provider);
+    if (worker == nullptr) {
+      std::promise<PaymentResult> missing;
+      missing.set_value({0, amount, false, provider});
+      return missing.get_future();
+    }
+    CheckoutJob *job = makeJob(amount);
+    auto future = job->promise.get_future();
+    worker->submit(job);
+    return future;
+  }
+
+  // Callback runs on the provider's worker thread — keep it short
+  void processCheckout(const std::string &provider, double amount,
+                       std::function<void(const PaymentResult &)> done) {
+    ProviderWorker *worker = workerFor(provider);
+    if (worker == nullptr) {
+      done({0, amount, false, provider});
+      return;
+    }
+    CheckoutJob *job = makeJob(amount);
+    job->callback = std::move(done);
+    worker->submit(job);
+  }
+};
+
+//
+// =======================================================
+// 6. BENCHMARK: PACED LOAD FROM 10k TO 100k CHECKOUTS/s
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+void runAtRate(int targetPerSecond, std::chrono::microseconds roundTrip) {
+  StandInGateway stripe("Stripe", roundTrip), razorpay("Razorpay", roundTrip),
+      paypal("PayPal", roundTrip);
+  const std::string providers[] = {"Stripe", "Razorpay", "PayPal"};
+  std::atomic<std::uint64_t> done{0};
+  std::atomic<std::uint64_t> latencyUsSum{0};
+
+  const auto duration = std::chrono::milliseconds(500);
+  const int producers = 2;
+  const auto total = std::uint64_t(targetPerSecond) * 500 / 1000;
+  Clock::time_point start, end;
+  {
+    AsyncCheckoutService service;
+    service.addGateway(stripe);
+    service.addGateway(razorpay);
+    service.addGateway(paypal);
+
+    start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+      threads.emplace_back([&, p] {
+        // Each producer submits its share, paced to the target rate
+        const auto interval = std::chrono::nanoseconds(
+            std::int64_t(1e9 * producers / targetPerSecond));
+        auto next = start;
+        for (std::uint64_t i = p; i < total; i += producers) {
+          next += interval;
+          while (Clock::now() < next) {
+            std::this_thread::sleep_until(next);
+          }
+          auto submitted = Clock::now();
+          service.processCheckout(
+              providers[i % 3], 10.0, [&, submitted](const PaymentResult &) {
+                auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    Clock::now() - submitted);
+                latencyUsSum.fetch_add(std::uint64_t(us.count()));
+                done.fetch_add(1);
+              });
+        }
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+    while (done.load() < total) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    end = Clock::now();
+  } // workers join here
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  std::cout << targetPerSecond << "/s target -> "
+            << int(double(done.load()) / seconds)
+            << "/s achieved, mean latency "
+            << double(latencyUsSum.load()) / double(done.load()) / 1000.0
+            << " ms (" << duration.count() << " ms run)\n";
+}
+
+void benchmark() {
+  const auto roundTrip = std::chrono::microseconds(2000);
+
+  // Baseline: the synchronous CheckoutService from interface.cpp
+  StandInGateway stripe("Stripe", roundTrip);
+  const int syncCount = 100;
+  auto start = Clock::now();
+  for (int i = 0; i < syncCount; ++i) {
+    stripe.initiatePayment(10.0);
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  std::cout << "Synchronous (2 ms round trip): " << int(syncCount / seconds)
+            << " checkouts/s\n\n";
+
+  for (int rate : {10000, 25000, 50000, 100000}) {
+    runAtRate(rate, roundTrip);
+  }
+}
+
+//
+// =======================================================
+// 7. DEMONSTRATION
+// =======================================================
+//
+
+int main() {
+  std::cout << "=== Async Batched Checkout Demo ===\n\n";
+
+  StandInGateway stripe("Stripe", std::chrono::milliseconds(5));
+  StandInGateway razorpay("Razorpay", std::chrono::milliseconds(5));
+  {
+    AsyncCheckoutService checkout;
+    checkout.addGateway(stripe);
+    checkout.addGateway(razorpay);
+
+    // Future style: submit now, wait later
+    auto f1 = checkout.processCheckout("Stripe", 99.99);
+    auto f2 = checkout.processCheckout("Razorpay", 1500.0);
+    auto f3 = checkout.processCheckout("PayPal", 49.99); // not configured
+
+    for (auto *f : {&f1, &f2, &f3}) {
+      PaymentResult r = f->get();
+      std::cout << (r.approved ? "✅ " : "⚠️  ") << r.provider << " #" << r.id
+                << " amount " << r.amount << "\n";
+    }
+
+    // Callback style
+    std::promise<void> finished;
+    checkout.processCheckout("Stripe", 5.0, [&](const PaymentResult &r) {
+      std::cout << "✅ callback: " << r.provider << " #" << r.id << "\n";
+      finished.set_value();
+    });
+    finished.get_future().wait();
+  }
+
+  std::cout << "\n=== Benchmark ===\n";
+  benchmark();
+
+  return 0;
+}
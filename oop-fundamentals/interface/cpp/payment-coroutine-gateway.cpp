@@ -0,0 +1,452 @@
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <latch>
+#include <new>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Companion to interface.cpp — 100k payments in flight on ONE thread.
+//
+// Build: g++ -std=c++20 -O2 -pthread payment-coroutine-gateway.cpp -o coro
+// Run:   ./coro [inFlight] [threadBaseline]   (default 100,000 / 2,000)
+
+//
+// =======================================================
+// 1. THREADS vs COROUTINES FOR WAITING
+// =======================================================
+//
+// A payment spends ~all of its life waiting for the provider. With
+// one blocking thread per checkout, every wait pins:
+//   - a kernel thread (scheduler entry, ~10 KB kernel stack)
+//   - a user stack (8 MB reserved, at least a few pages touched)
+//   - a context switch on each wake-up
+//
+// A C++20 coroutine suspends instead: its locals live in a heap
+// FRAME of a few hundred bytes, and an event loop resumes it when the
+// I/O (here: a timer standing in for the network) completes.
+//
+//   co_await gateway.initiatePaymentAsync(amount)
+//        │ suspend: frame parked in the loop's timer heap
+//        ▼
+//   epoll_wait() ── timerfd fires ──▶ resume frame ──▶ co_return result
+
+//
+// =======================================================
+// 2. Task<T>: A LAZY, AWAITABLE COROUTINE
+// =======================================================
+//
+
+// Every coroutine frame in this file is counted, so the benchmark can
+// report exact bytes per in-flight payment.
+struct FrameStats {
+  static inline std::size_t live = 0;
+  static inline std::size_t allocatedBytes = 0; // running total
+};
+
+struct CountedFrame {
+  static void *operator new(std::size_t n) {
+    ++FrameStats::live;
+    FrameStats::allocatedBytes += n;
+    return ::operator new(n);
+  }
+  static void operator delete(void *p) {
+    --FrameStats::live;
+    ::operator delete(p);
+  }
+};
+
+template <typename T> class Task {
+public:
+  struct promise_type : CountedFrame {
+    std::optional<T> value;
+    std::coroutine_handle<> continuation;
+
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    // Lazy: nothing runs until someone co_awaits the task
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // On completion, jump straight back to the awaiting coroutine
+    // (symmetric transfer: no recursion, no stack growth)
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+        auto next = h.promise().continuation;
+        return next ? next : std::noop_coroutine();
+      }
+      void await_resume() noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void return_value(T v) { value = std::move(v); }
+    void unhandled_exception() { std::terminate(); }
+  };
+
+private:
+  std::coroutine_handle<promise_type> handle_;
+
+  explicit Task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+
+public:
+  Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  ~Task() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  bool await_ready() const noexcept { return false; }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) {
+    handle_.promise().continuation = awaiting;
+    return handle_; // start the child now
+  }
+  T await_resume() { return std::move(*handle_.promise().value); }
+};
+
+// Fire-and-forget root: starts eagerly, frees itself when done
+struct Detached {
+  struct promise_type : CountedFrame {
+    Detached get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+template <typename T, typename Fn> Detached spawn(Task<T> task, Fn onDone) {
+  onDone(co_await task);
+}
+
+//
+// =======================================================
+// 3. EVENT LOOP: epoll + ONE timerfd + A TIMER HEAP
+// =======================================================
+//
+// Real gateways would register their sockets with the same epoll set;
+// here the "network" is a timer per payment. Only the EARLIEST
+// deadline is armed in the kernel, so 100k timers cost one fd.
+
+class EventLoop {
+private:
+  using Clock = std::chrono::steady_clock; // CLOCK_MONOTONIC on Linux
+
+  struct Timer {
+    Clock::time_point at;
+    std::coroutine_handle<> waiter;
+    bool operator>(const Timer &o) const { return at > o.at; }
+  };
+
+  int epoll_ = -1;
+  int timerFd_ = -1;
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+  Clock::time_point armed_ = Clock::time_point::max();
+
+  void arm(Clock::time_point at) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  at.time_since_epoch())
+                  .count();
+    itimerspec spec{};
+    spec.it_value.tv_sec = ns / 1000000000;
+    spec.it_value.tv_nsec = ns % 1000000000;
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+      spec.it_value.tv_nsec = 1; // all-zero would DISARM the timer
+    }
+    timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+    armed_ = at;
+  }
+
+public:
+  EventLoop() {
+    epoll_ = epoll_create1(EPOLL_CLOEXEC);
+    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epoll_ >= 0 && timerFd_ >= 0) {
+      epoll_event ev{};
+      ev.events = EPOLLIN;
+      ev.data.fd = timerFd_;
+      epoll_ctl(epoll_, EPOLL_CTL_ADD, timerFd_, &ev);
+    }
+  }
+
+  ~EventLoop() {
+    if (timerFd_ >= 0) {
+      close(timerFd_);
+    }
+    if (epoll_ >= 0) {
+      close(epoll_);
+    }
+  }
+
+  bool ok() const { return epoll_ >= 0 && timerFd_ >= 0; }
+  std::size_t pendingTimers() const { return timers_.size(); }
+
+  // co_await loop.sleepFor(d): park the coroutine until d has elapsed
+  auto sleepFor(std::chrono::microseconds d) {
+    struct Awaiter {
+      EventLoop &loop;
+      Clock::time_point at;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> h) {
+        loop.timers_.push({at, h});
+        if (at < loop.armed_) {
+          loop.arm(at);
+        }
+      }
+      void await_resume() const noexcept {}
+    };
+    return Awaiter{*this, Clock::now() + d};
+  }
+
+  // Runs until no coroutine is waiting on the loop
+  void run() {
+    epoll_event events[8];
+    while (!timers_.empty()) {
+      int n = epoll_wait(epoll_, events, 8, -1);
+      if (n <= 0) {
+        continue; // EINTR
+      }
+      std::uint64_t expirations;
+      if (read(timerFd_, &expirations, sizeof(expirations)) < 0) {
+        // spurious wake-up: EAGAIN, the heap check below still applies
+      }
+      auto now = Clock::now();
+      armed_ = Clock::time_point::max();
+      while (!timers_.empty() && timers_.top().at <= now) {
+        auto waiter = timers_.top().waiter;
+        timers_.pop(); // pop first: resuming may push new timers
+        waiter.resume();
+      }
+      if (!timers_.empty() && timers_.top().at < armed_) {
+        arm(timers_.top().at);
+      }
+    }
+  }
+};
+
+//
+// =======================================================
+// 4. PAYMENT GATEWAY WITH AN ASYNC ENTRY POINT
+// =======================================================
+//
+
+struct PaymentResult {
+  std::uint64_t id = 0;
+  double amount = 0;
+  bool approved = false;
+  std::string provider;
+};
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual void initiatePayment(double amount) = 0;
+  virtual std::string getProviderName() const = 0;
+
+  // A virtual function may itself be a coroutine
+  virtual Task<PaymentResult> initiatePaymentAsync(std::uint64_t id,
+                                                   double amount) = 0;
+};
+
+// Local stand-in for Stripe/Razorpay/PayPal: one simulated network
+// round trip, blocking or asynchronous.
+class StandInGateway : public PaymentGateway {
+private:
+  std::string name_;
+  EventLoop &loop_;
+  std::chrono::microseconds minLatency_, maxLatency_;
+  std::mt19937 rng_{64};
+
+  std::chrono::microseconds roundTrip() {
+    std::uniform_int_distribution<long> pick(minLatency_.count(),
+                                             maxLatency_.count());
+    return std::chrono::microseconds(pick(rng_));
+  }
+
+public:
+  StandInGateway(const std::string &name, EventLoop &loop,
+                 std::chrono::microseconds minLatency,
+                 std::chrono::microseconds maxLatency)
+      : name_(name), loop_(loop), minLatency_(minLatency),
+        maxLatency_(maxLatency) {}
+
+  // Blocking baseline (called from one thread per checkout). The RNG
+  // is per thread here: rng_ belongs to the event-loop thread.
+  void initiatePayment(double) override {
+    thread_local std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<long> pick(minLatency_.count(),
+                                             maxLatency_.count());
+    std::this_thread::sleep_for(std::chrono::microseconds(pick(rng)));
+  }
+
+  std::string getProviderName() const override { return name_; }
+
+  Task<PaymentResult> initiatePaymentAsync(std::uint64_t id,
+                                           double amount) override {
+    co_await loop_.sleepFor(roundTrip());
+    co_return PaymentResult{id, amount, true, name_};
+  }
+};
+
+class CheckoutService {
+private:
+  PaymentGateway *gateway_;
+
+public:
+  explicit CheckoutService(PaymentGateway *gateway) : gateway_(gateway) {}
+
+  void setPaymentGateway(PaymentGateway *gateway) { gateway_ = gateway; }
+
+  Task<PaymentResult> processCheckoutAsync(std::uint64_t id, double amount) {
+    if (gateway_ == nullptr) {
+      std::cout << "⚠️  No payment gateway configured!\n";
+      co_return PaymentResult{id, amount, false, ""};
+    }
+    co_return co_await gateway_->initiatePaymentAsync(id, amount);
+  }
+};
+
+//
+// =======================================================
+// 5. BENCHMARK: COROUTINES vs THREAD PER CHECKOUT
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+// Resident memory in KB, from /proc
+long residentKb() {
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmRSS:") {
+      long kb = 0;
+      status >> kb;
+      return kb;
+    }
+  }
+  return 0;
+}
+
+void benchmark(std::size_t inFlight, std::size_t threadCount) {
+  using std::chrono::milliseconds;
+  EventLoop loop;
+  if (!loop.ok()) {
+    std::cout << "⚠️  epoll/timerfd unavailable\n";
+    return;
+  }
+  StandInGateway stripe("Stripe", loop, milliseconds(20), milliseconds(80));
+  CheckoutService checkout(&stripe);
+
+  std::size_t completed = 0;
+  std::size_t bytesBefore = FrameStats::allocatedBytes;
+  long rssBefore = residentKb();
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < inFlight; ++i) {
+    spawn(checkout.processCheckoutAsync(i, 10.0),
+          [&completed](PaymentResult r) { completed += r.approved; });
+  }
+  // Every payment is now suspended inside the gateway
+  std::size_t frameBytes = FrameStats::allocatedBytes - bytesBefore;
+  long rssInFlight = residentKb();
+  loop.run();
+  double coroMs = millisSince(start);
+  std::cout << "Coroutines, 1 thread:   " << completed << " payments in "
+            << coroMs << " ms (" << double(completed) / coroMs * 1000.0
+            << "/s)\n"
+            << "  frames:  " << double(frameBytes) / double(inFlight)
+            << " bytes/payment, RSS +"
+            << double(rssInFlight - rssBefore) * 1024.0 / double(inFlight)
+            << " bytes/payment\n"
+            << "  frames still alive: " << FrameStats::live << "\n";
+
+  std::atomic<std::size_t> done{0};
+  std::latch started{std::ptrdiff_t(threadCount)}, release{1};
+  rssBefore = residentKb();
+  start = Clock::now();
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount);
+  for (std::size_t i = 0; i < threadCount; ++i) {
+    threads.emplace_back([&] {
+      started.count_down();
+      release.wait(); // hold everyone to sample peak memory
+      stripe.initiatePayment(10.0);
+      done.fetch_add(1);
+    });
+  }
+  started.wait();
+  long rssThreads = residentKb();
+  double spawnMs = millisSince(start);
+  release.count_down();
+  for (auto &t : threads) {
+    t.join();
+  }
+  double threadMs = millisSince(start);
+  std::cout << "Thread per checkout:    " << done.load() << " payments in "
+            << threadMs << " ms (" << double(done.load()) / threadMs * 1000.0
+            << "/s, " << spawnMs << " ms just to start threads)\n"
+            << "  RSS +"
+            << double(rssThreads - rssBefore) * 1024.0 / double(threadCount)
+            << " bytes/payment (plus 8 MB reserved stack each)\n";
+}
+
+//
+// =======================================================
+// 6. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Coroutine Payment Gateway Demo ===\n\n";
+
+  {
+    using std::chrono::milliseconds;
+    EventLoop loop;
+    StandInGateway stripe("Stripe", loop, milliseconds(30), milliseconds(30));
+    StandInGateway razorpay("Razorpay", loop, milliseconds(10),
+                            milliseconds(10));
+    CheckoutService slow(&stripe), fast(&razorpay);
+    auto print = [](PaymentResult r) {
+      std::cout << "✅ #" << r.id << " " << r.amount << " via " << r.provider
+                << "\n";
+    };
+    // Started in this order, finish in latency order — one thread
+    spawn(slow.processCheckoutAsync(1, 99.99), print);
+    spawn(fast.processCheckoutAsync(2, 1500.0), print);
+    std::cout << "Both payments in flight, " << loop.pendingTimers()
+              << " timers pending\n";
+    loop.run();
+  }
+
+  std::size_t inFlight = argc > 1 ? std::stoul(argv[1]) : 100000;
+  std::size_t threadCount = argc > 2 ? std::stoul(argv[2]) : 2000;
+  std::cout << "\n=== Benchmark (" << inFlight << " coroutines, "
+            << threadCount << " threads, 20-80 ms per payment) ===\n";
+  benchmark(inFlight, threadCount);
+
+  return 0;
+}
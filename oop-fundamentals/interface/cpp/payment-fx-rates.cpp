@@ -0,0 +1,440 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Companion to interface.cpp — convert ₹ and $ without a lock.
+//
+// Build: g++ -std=c++17 -O2 -pthread payment-fx-rates.cpp -o fx
+// Run:   ./fx [readerThreads]   (default 4, rates updated at 100 Hz)
+
+//
+// =======================================================
+// 1. THE FX TABLE
+// =======================================================
+//
+// Razorpay charges in ₹, Stripe and PayPal in $, so a multi-gateway
+// checkout converts on every payment. The rates change ~100 times a
+// second; conversions happen millions of times a second.
+//
+//   reader:  snapshot = current_.load()      <- no lock, no CAS
+//            minorTo  = minorFrom * snapshot->cross[from][to] / 1e15
+//
+//   writer:  build a NEW immutable snapshot (all 16 cross rates)
+//            old = current_.exchange(new)    <- one atomic swap
+//            retire(old)                     <- freed once no reader
+//                                               can still hold it
+//
+// Readers always see one consistent snapshot: never USD->INR from one
+// update and INR->EUR from the next. Reclamation uses the epochs of
+// payment-gateway-hot-swap.cpp.
+//
+// FIXED POINT: a rate is an integer in units of 1e-15, amounts are
+// integer minor units (paise, cents, yen), and the product is taken in
+// 128 bits and rounded once, half away from zero. A quoted 83.35 is
+// 83.349999... as a double, so a payment that lands exactly on half a
+// paisa rounds the wrong way and no longer matches the gateway's own
+// conversion.
+
+//
+// =======================================================
+// 2. CURRENCIES AND AMOUNTS
+// =======================================================
+//
+
+enum class Currency : std::uint8_t { USD, INR, EUR, JPY };
+constexpr std::size_t kCurrencyCount = 4;
+
+struct CurrencyInfo {
+  const char *code;
+  const char *symbol; // UTF-8
+  std::uint8_t decimals;
+};
+
+constexpr CurrencyInfo kCurrencies[] = {
+    {"USD", "$", 2}, {"INR", "₹", 2}, {"EUR", "€", 2}, {"JPY", "¥", 0}};
+
+struct Amount {
+  std::int64_t minor; // paise, cents, yen
+  Currency currency;
+};
+
+std::string toString(Amount a) {
+  const CurrencyInfo &c = kCurrencies[std::size_t(a.currency)];
+  char buffer[48];
+  // Sign and magnitude separately: -5 paise is "-₹0.05", not "₹0.-5".
+  // Unsigned, so that INT64_MIN has a magnitude too.
+  const char *sign = a.minor < 0 ? "-" : "";
+  std::uint64_t abs = a.minor < 0 ? 0 - std::uint64_t(a.minor)
+                                  : std::uint64_t(a.minor);
+  if (c.decimals == 0) {
+    std::snprintf(buffer, sizeof(buffer), "%s%s%llu", sign, c.symbol,
+                  (unsigned long long)abs);
+  } else {
+    std::snprintf(buffer, sizeof(buffer), "%s%s%llu.%02llu", sign, c.symbol,
+                  (unsigned long long)(abs / 100),
+                  (unsigned long long)(abs % 100));
+  }
+  return buffer;
+}
+
+//
+// =======================================================
+// 3. SNAPSHOTS AND FIXED-POINT CONVERSION
+// =======================================================
+//
+
+constexpr std::int64_t kRateScale = 1000000000000000; // 1e-15 units
+
+// A quote written in millionths, e.g. micro(83350000) for 83.35
+constexpr std::int64_t micro(std::int64_t v) {
+  return v * (kRateScale / 1000000);
+}
+
+// x / d rounded half away from zero
+std::int64_t divideRounded(__int128 x, __int128 d) {
+  __int128 q = (x < 0 ? x - d / 2 : x + d / 2) / d;
+  return std::int64_t(q);
+}
+
+struct FxSnapshot {
+  std::uint64_t version;
+  // Minor units of `to` per minor unit of `from`, times kRateScale.
+  // Precomputed once per update so a conversion is one multiply.
+  std::int64_t cross[kCurrencyCount][kCurrencyCount];
+
+  // perUsd[c] = units of c for 1 USD, times kRateScale
+  FxSnapshot(std::uint64_t v, const std::int64_t (&perUsd)[kCurrencyCount])
+      : version(v) {
+    for (std::size_t f = 0; f < kCurrencyCount; ++f) {
+      for (std::size_t t = 0; t < kCurrencyCount; ++t) {
+        __int128 num = __int128(perUsd[t]) * kRateScale;
+        __int128 den = perUsd[f];
+        int shift = kCurrencies[t].decimals - kCurrencies[f].decimals;
+        for (; shift > 0; --shift) {
+          num *= 10;
+        }
+        for (; shift < 0; ++shift) {
+          den *= 10;
+        }
+        cross[f][t] = divideRounded(num, den);
+      }
+    }
+  }
+
+  Amount convert(Amount a, Currency to) const {
+    std::int64_t rate = cross[std::size_t(a.currency)][std::size_t(to)];
+    return {divideRounded(__int128(a.minor) * rate, kRateScale), to};
+  }
+};
+
+//
+// =======================================================
+// 4. EPOCH-BASED RECLAMATION (see payment-gateway-hot-swap.cpp)
+// =======================================================
+//
+
+class EpochDomain {
+public:
+  class Registration;
+
+private:
+  static constexpr std::size_t kMaxThreads = 128;
+
+  struct alignas(64) Slot {
+    std::atomic<std::uint64_t> epoch{0};
+    std::atomic<bool> claimed{false};
+  };
+
+  struct Retired {
+    std::uint64_t epoch;
+    std::unique_ptr<const FxSnapshot> snapshot;
+  };
+
+  std::atomic<std::uint64_t> global_{1};
+  Slot slots_[kMaxThreads];
+  std::mutex writerMutex_; // writers only
+  std::vector<Retired> retired_;
+
+  static Registration *&registrations() {
+    thread_local Registration *head = nullptr;
+    return head;
+  }
+
+  Slot &claimSlot() {
+    for (auto &s : slots_) {
+      bool expected = false;
+      if (s.claimed.compare_exchange_strong(expected, true)) {
+        return s;
+      }
+    }
+    std::fprintf(stderr, "EpochDomain: more than %zu reader threads\n",
+                 kMaxThreads);
+    std::abort();
+  }
+
+  Slot &mySlot();
+
+  bool tryAdvance() {
+    std::uint64_t current = global_.load();
+    for (const auto &s : slots_) {
+      std::uint64_t e = s.epoch.load();
+      if (e != 0 && e != current) {
+        return false;
+      }
+    }
+    return global_.compare_exchange_strong(current, current + 1);
+  }
+
+public:
+  // Held by each reader thread while it reads; releases its slot
+  class Registration {
+  private:
+    EpochDomain &domain_;
+    Slot &slot_;
+    Registration *outer_;
+    friend class EpochDomain;
+
+  public:
+    explicit Registration(EpochDomain &domain)
+        : domain_(domain), slot_(domain.claimSlot()),
+          outer_(registrations()) {
+      registrations() = this;
+    }
+    ~Registration() {
+      registrations() = outer_;
+      slot_.epoch.store(0, std::memory_order_release);
+      slot_.claimed.store(false, std::memory_order_release);
+    }
+    Registration(const Registration &) = delete;
+    Registration &operator=(const Registration &) = delete;
+  };
+
+  class Guard {
+  private:
+    Slot &slot_;
+
+  public:
+    explicit Guard(EpochDomain &domain) : slot_(domain.mySlot()) {
+      slot_.epoch.store(domain.global_.load());
+    }
+    ~Guard() { slot_.epoch.store(0, std::memory_order_release); }
+  };
+
+  void retire(std::unique_ptr<const FxSnapshot> snapshot) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    retired_.push_back({global_.load(), std::move(snapshot)});
+    tryAdvance();
+    std::uint64_t now = global_.load();
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                  [now](const Retired &r) {
+                                    return r.epoch + 2 <= now;
+                                  }),
+                   retired_.end());
+  }
+
+  std::size_t pendingReclaim() {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    return retired_.size();
+  }
+};
+
+EpochDomain::Slot &EpochDomain::mySlot() {
+  for (Registration *r = registrations(); r != nullptr; r = r->outer_) {
+    if (&r->domain_ == this) {
+      return r->slot_;
+    }
+  }
+  std::fprintf(stderr, "EpochDomain: reader thread is not registered\n");
+  std::abort();
+}
+
+//
+// =======================================================
+// 5. THE FX TABLE + A LOCKED BASELINE
+// =======================================================
+//
+
+class FxTable {
+private:
+  EpochDomain epochs_;
+  std::atomic<const FxSnapshot *> current_;
+  std::uint64_t nextVersion_ = 1;
+
+public:
+  explicit FxTable(const std::int64_t (&perUsd)[kCurrencyCount])
+      : current_(new FxSnapshot(0, perUsd)) {}
+
+  ~FxTable() { delete current_.load(); }
+
+  // One writer (the rate feed) at a time
+  void publish(const std::int64_t (&perUsd)[kCurrencyCount]) {
+    auto *next = new FxSnapshot(nextVersion_++, perUsd);
+    const FxSnapshot *old = current_.exchange(next);
+    epochs_.retire(std::unique_ptr<const FxSnapshot>(old));
+  }
+
+  // Each thread that calls convert() holds one of these
+  EpochDomain::Registration readerScope() {
+    return EpochDomain::Registration(epochs_);
+  }
+
+  Amount convert(Amount a, Currency to) {
+    EpochDomain::Guard guard(epochs_);
+    return current_.load(std::memory_order_acquire)->convert(a, to);
+  }
+
+  std::size_t pendingReclaim() { return epochs_.pendingReclaim(); }
+};
+
+// Same snapshot math, but readers take a shared lock
+struct NoReaderScope {};
+
+class SharedMutexFxTable {
+private:
+  std::shared_mutex mutex_;
+  FxSnapshot snapshot_;
+
+public:
+  explicit SharedMutexFxTable(const std::int64_t (&perUsd)[kCurrencyCount])
+      : snapshot_(0, perUsd) {}
+
+  void publish(const std::int64_t (&perUsd)[kCurrencyCount]) {
+    FxSnapshot next(snapshot_.version + 1, perUsd); // build outside lock
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    snapshot_ = next;
+  }
+
+  NoReaderScope readerScope() { return {}; }
+
+  Amount convert(Amount a, Currency to) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return snapshot_.convert(a, to);
+  }
+};
+
+//
+// =======================================================
+// 6. BENCHMARK: CONVERSIONS/s WHILE RATES TICK AT 100 Hz
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+// INR/USD ~83.12, EUR ~0.92, JPY ~149.5
+constexpr std::int64_t kStartRates[kCurrencyCount] = {
+    micro(1000000), micro(83120000), micro(920000), micro(149500000)};
+
+template <typename Table>
+double run(int readers, std::chrono::milliseconds length) {
+  Table table(kStartRates);
+  std::atomic<bool> stop{false};
+  std::atomic<std::uint64_t> total{0};
+
+  std::thread feed([&] { // random walk of every rate, every 10 ms
+    std::mt19937_64 rng(74);
+    std::normal_distribution<double> step(0.0, 0.0002);
+    std::int64_t rates[kCurrencyCount];
+    std::copy(std::begin(kStartRates), std::end(kStartRates), rates);
+    auto next = Clock::now();
+    while (!stop.load()) {
+      for (std::size_t c = 1; c < kCurrencyCount; ++c) {
+        rates[c] += std::int64_t(double(rates[c]) * step(rng));
+      }
+      table.publish(rates);
+      next += std::chrono::milliseconds(10);
+      std::this_thread::sleep_until(next);
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; ++r) {
+    threads.emplace_back([&, r] {
+      [[maybe_unused]] auto scope = table.readerScope();
+      std::uint64_t count = 0, x = std::uint64_t(r) + 1;
+      std::int64_t sink = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < 1024; ++i) {
+          x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+          Amount a{std::int64_t(x >> 44), Currency((x >> 20) & 3)};
+          sink += table.convert(a, Currency((x >> 30) & 3)).minor;
+        }
+        count += 1024;
+      }
+      total += count + (sink == 42); // keep `sink` alive
+    });
+  }
+
+  std::this_thread::sleep_for(length);
+  stop.store(true);
+  for (auto &t : threads) {
+    t.join();
+  }
+  feed.join();
+  return double(total.load()) /
+         std::chrono::duration<double>(length).count();
+}
+
+//
+// =======================================================
+// 7. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Lock-Free FX Table Demo ===\n\n";
+
+  FxTable table(kStartRates);
+  auto scope = table.readerScope();
+  Amount cart{4999, Currency::USD};
+  std::cout << "💳 Stripe charges " << toString(cart)
+            << ", Razorpay would charge "
+            << toString(table.convert(cart, Currency::INR)) << "\n";
+  std::int64_t moved[kCurrencyCount] = {micro(1000000), micro(83350000),
+                                        micro(921000), micro(150100000)};
+  table.publish(moved);
+  std::cout << "Rates updated: Razorpay now charges "
+            << toString(table.convert(cart, Currency::INR)) << ", "
+            << toString(table.convert({100000, Currency::INR}, Currency::JPY))
+            << " for ₹1000.00\n";
+  Amount refund{-599, Currency::USD};
+  std::cout << "A " << toString(refund) << " refund becomes "
+            << toString(table.convert(refund, Currency::INR)) << "\n";
+
+  // Fixed point vs double on the same quote: every $0.01..$10,000.00
+  FxSnapshot snapshot(0, moved);
+  const double inrPerUsd = 83.35;
+  std::size_t differ = 0, samples = 1000000;
+  for (std::int64_t cents = 1; cents <= std::int64_t(samples); ++cents) {
+    std::int64_t exact =
+        snapshot.convert({cents, Currency::USD}, Currency::INR).minor;
+    std::int64_t viaDouble =
+        std::llround(double(cents) / 100.0 * inrPerUsd * 100.0);
+    differ += exact != viaDouble;
+  }
+  std::cout << "double vs fixed point: " << differ << " of " << samples
+            << " $->₹ conversions land on a different paisa\n";
+
+  int readers = argc > 1 ? std::stoi(argv[1]) : 4;
+  auto length = std::chrono::milliseconds(2000);
+  std::cout << "\n=== Benchmark (" << readers << " readers, "
+            << std::thread::hardware_concurrency() << " cores, 2 s each) ===\n";
+  std::printf("shared_mutex table: %7.1f M conversions/s\n",
+              run<SharedMutexFxTable>(readers, length) / 1e6);
+  std::printf("RCU snapshot table: %7.1f M conversions/s\n",
+              run<FxTable>(readers, length) / 1e6);
+
+  return 0;
+}
@@ -0,0 +1,422 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Companion to interface.cpp — swap the gateway while checkouts run.
+//
+// Build: g++ -std=c++17 -O2 -pthread payment-gateway-hot-swap.cpp -o hot-swap
+// Run:   ./hot-swap [readerThreads]   (default 4)
+
+//
+// =======================================================
+// 1. THE RACE IN setPaymentGateway()
+// =======================================================
+//
+//     void setPaymentGateway(PaymentGateway *g) { gateway_ = g; }
+//
+// If another thread is inside processCheckout() it may read a torn or
+// stale pointer — and if the old gateway is deleted, use it after free.
+//
+// Options:
+//   ❌ std::mutex around every checkout — correct, but readers now
+//      serialise on one lock and its cache line
+//   ✅ RCU (Read-Copy-Update):
+//      - readers: load an atomic pointer, use it. No lock, no write
+//        to shared memory except their own epoch slot.
+//      - writer: publish the new pointer with one atomic exchange and
+//        RETIRE the old one; it is freed only once no reader can
+//        still hold it. "No reader can" is tracked with EPOCHS.
+
+//
+// =======================================================
+// 2. PAYMENT GATEWAY (as in interface.cpp)
+// =======================================================
+//
+// The stand-in does a little arithmetic instead of printing so the
+// benchmark measures the swap machinery.
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual void initiatePayment(double amount) = 0;
+  virtual std::string getProviderName() const = 0;
+};
+
+class StandInGateway : public PaymentGateway {
+private:
+  std::string name_;
+  double feeRate_;
+  static std::atomic<int> alive_; // leak / double-free detector
+
+public:
+  StandInGateway(const std::string &name, double feeRate)
+      : name_(name), feeRate_(feeRate) {
+    alive_.fetch_add(1);
+  }
+  ~StandInGateway() override { alive_.fetch_sub(1); }
+
+  static int alive() { return alive_.load(); }
+
+  void initiatePayment(double amount) override {
+    volatile double fee = amount * feeRate_; // stands in for real work
+    (void)fee;
+  }
+
+  std::string getProviderName() const override { return name_; }
+};
+std::atomic<int> StandInGateway::alive_{0};
+
+//
+// =======================================================
+// 3. EPOCH-BASED RECLAMATION
+// =======================================================
+//
+// - A global epoch counter starts at 1.
+// - A reader entering a critical section copies the global epoch into
+//   its own slot; leaving writes 0 ("quiescent").
+// - The epoch may advance only when every busy reader has seen the
+//   current value.
+// - Anything retired in epoch E is unreachable by epoch E + 2: every
+//   reader that could have loaded it has left by then.
+
+class EpochDomain {
+public:
+  class Registration;
+
+private:
+  static constexpr std::size_t kMaxThreads = 128;
+
+  struct alignas(64) Slot { // one cache line each: no false sharing
+    std::atomic<std::uint64_t> epoch{0};
+    std::atomic<bool> claimed{false};
+  };
+
+  struct Retired {
+    std::uint64_t epoch;
+    std::unique_ptr<PaymentGateway> object;
+  };
+
+  std::atomic<std::uint64_t> global_{1};
+  Slot slots_[kMaxThreads];
+  std::mutex writerMutex_; // writers are rare; readers never take it
+  std::vector<Retired> retired_;
+
+  // This thread's registrations, innermost first. Keyed by domain, so a
+  // thread that reads from two domains publishes into the right one.
+  static Registration *&registrations() {
+    thread_local Registration *head = nullptr;
+    return head;
+  }
+
+  Slot &claimSlot() {
+    for (auto &s : slots_) {
+      bool expected = false;
+      if (s.claimed.compare_exchange_strong(expected, true)) {
+        return s;
+      }
+    }
+    std::fprintf(stderr, "EpochDomain: more than %zu reader threads\n",
+                 kMaxThreads);
+    std::abort(); // a silently shared slot would free memory in use
+  }
+
+  Slot &mySlot();
+
+  bool tryAdvance() {
+    std::uint64_t current = global_.load();
+    for (const auto &s : slots_) {
+      std::uint64_t e = s.epoch.load();
+      if (e != 0 && e != current) {
+        return false; // someone is still reading in an older epoch
+      }
+    }
+    return global_.compare_exchange_strong(current, current + 1);
+  }
+
+public:
+  // A reader thread holds one of these (per domain) for as long as it
+  // reads. It claims a slot and gives it back when the thread is done,
+  // so threads that come and go never exhaust the kMaxThreads slots.
+  // Registrations nest: destroy them in reverse order of creation.
+  class Registration {
+  private:
+    EpochDomain &domain_;
+    Slot &slot_;
+    Registration *outer_;
+    friend class EpochDomain;
+
+  public:
+    explicit Registration(EpochDomain &domain)
+        : domain_(domain), slot_(domain.claimSlot()),
+          outer_(registrations()) {
+      registrations() = this;
+    }
+    ~Registration() {
+      registrations() = outer_;
+      slot_.epoch.store(0, std::memory_order_release);
+      slot_.claimed.store(false, std::memory_order_release);
+    }
+    Registration(const Registration &) = delete;
+    Registration &operator=(const Registration &) = delete;
+  };
+
+  // RAII read-side critical section; the thread must be registered
+  class Guard {
+  private:
+    Slot &slot_;
+
+  public:
+    explicit Guard(EpochDomain &domain) : slot_(domain.mySlot()) {
+      // seq_cst store: must be visible before we load the pointer
+      slot_.epoch.store(domain.global_.load());
+    }
+    ~Guard() { slot_.epoch.store(0, std::memory_order_release); }
+  };
+
+  void retire(std::unique_ptr<PaymentGateway> object) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    retired_.push_back({global_.load(), std::move(object)});
+    tryAdvance();
+    std::uint64_t now = global_.load();
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                  [now](const Retired &r) {
+                                    return r.epoch + 2 <= now;
+                                  }),
+                   retired_.end());
+  }
+
+  std::size_t pendingReclaim() {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    return retired_.size();
+  }
+};
+
+EpochDomain::Slot &EpochDomain::mySlot() {
+  for (Registration *r = registrations(); r != nullptr; r = r->outer_) {
+    if (&r->domain_ == this) {
+      return r->slot_;
+    }
+  }
+  std::fprintf(stderr, "EpochDomain: reader thread is not registered\n");
+  std::abort();
+}
+
+//
+// =======================================================
+// 4. CHECKOUT SERVICE WITH LOCK-FREE READS
+// =======================================================
+//
+// The service now OWNS its gateway: someone has to decide when it is
+// safe to delete the old one, and that is exactly what RCU is for.
+
+class CheckoutService {
+private:
+  EpochDomain &epochs_;
+  std::atomic<PaymentGateway *> gateway_{nullptr};
+
+public:
+  CheckoutService(EpochDomain &epochs, std::unique_ptr<PaymentGateway> gateway)
+      : epochs_(epochs), gateway_(gateway.release()) {}
+
+  ~CheckoutService() { delete gateway_.load(); }
+
+  void setPaymentGateway(std::unique_ptr<PaymentGateway> gateway) {
+    PaymentGateway *old = gateway_.exchange(gateway.release());
+    epochs_.retire(std::unique_ptr<PaymentGateway>(old));
+  }
+
+  // Each thread that calls processCheckout() holds one of these
+  EpochDomain::Registration readerScope() {
+    return EpochDomain::Registration(epochs_);
+  }
+
+  void processCheckout(double amount, bool verbose = false) {
+    EpochDomain::Guard guard(epochs_);
+    PaymentGateway *gateway = gateway_.load(std::memory_order_acquire);
+    if (gateway != nullptr) {
+      if (verbose) {
+        std::cout << "Using " << gateway->getProviderName() << "...\n";
+      }
+      gateway->initiatePayment(amount);
+    } else {
+      std::cout << "⚠️  No payment gateway configured!\n";
+    }
+  }
+};
+
+// Baselines for the benchmark: the same service with a lock
+struct NoReaderScope {};
+
+class MutexCheckoutService {
+private:
+  std::mutex mutex_;
+  std::unique_ptr<PaymentGateway> gateway_;
+
+public:
+  explicit MutexCheckoutService(std::unique_ptr<PaymentGateway> gateway)
+      : gateway_(std::move(gateway)) {}
+
+  void setPaymentGateway(std::unique_ptr<PaymentGateway> gateway) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gateway_ = std::move(gateway);
+  }
+
+  NoReaderScope readerScope() { return {}; }
+
+  void processCheckout(double amount) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gateway_->initiatePayment(amount);
+  }
+};
+
+class SharedMutexCheckoutService {
+private:
+  std::shared_mutex mutex_;
+  std::unique_ptr<PaymentGateway> gateway_;
+
+public:
+  explicit SharedMutexCheckoutService(std::unique_ptr<PaymentGateway> gateway)
+      : gateway_(std::move(gateway)) {}
+
+  void setPaymentGateway(std::unique_ptr<PaymentGateway> gateway) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    gateway_ = std::move(gateway);
+  }
+
+  NoReaderScope readerScope() { return {}; }
+
+  void processCheckout(double amount) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    gateway_->initiatePayment(amount);
+  }
+};
+
+//
+// =======================================================
+// 5. BENCHMARK: THROUGHPUT WHILE SWAPPING EVERY 1 ms
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+struct RunResult {
+  double perSecond;
+  int swaps; // a writer starved by readers completes few or none
+};
+
+template <typename Service>
+RunResult run(Service &service, int readers, bool swapping) {
+  std::atomic<bool> stop{false};
+  std::atomic<std::uint64_t> total{0};
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; ++r) {
+    threads.emplace_back([&] {
+      [[maybe_unused]] auto scope = service.readerScope();
+      std::uint64_t local = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        service.processCheckout(10.0);
+        ++local;
+      }
+      total.fetch_add(local);
+    });
+  }
+
+  // The deadline lives on its own thread: if the writer below is stuck
+  // waiting for a lock, the readers must still be told to stop.
+  auto start = Clock::now();
+  std::thread timer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    stop.store(true);
+  });
+
+  int swaps = 0;
+  while (!stop.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (swapping && !stop.load()) {
+      const char *name = swaps % 2 == 0 ? "Razorpay" : "Stripe";
+      service.setPaymentGateway(
+          std::make_unique<StandInGateway>(name, 0.02 + swaps % 3 * 0.001));
+      ++swaps;
+    }
+  }
+  timer.join();
+  for (auto &t : threads) {
+    t.join();
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  return {double(total.load()) / seconds, swaps};
+}
+
+void benchmark(int readers) {
+  auto fresh = [] { return std::make_unique<StandInGateway>("Stripe", 0.02); };
+  EpochDomain epochs;
+
+  {
+    CheckoutService rcu(epochs, fresh());
+    RunResult still = run(rcu, readers, false);
+    RunResult swapping = run(rcu, readers, true);
+    std::cout << "RCU / epochs:   " << still.perSecond / 1e6
+              << " M/s steady, " << swapping.perSecond / 1e6
+              << " M/s while swapping (" << swapping.swaps << " swaps)\n";
+  }
+  {
+    MutexCheckoutService locked(fresh());
+    RunResult swapping = run(locked, readers, true);
+    std::cout << "std::mutex:     " << swapping.perSecond / 1e6
+              << " M/s while swapping (" << swapping.swaps << " swaps)\n";
+  }
+  {
+    SharedMutexCheckoutService shared(fresh());
+    RunResult swapping = run(shared, readers, true);
+    std::cout << "shared_mutex:   " << swapping.perSecond / 1e6
+              << " M/s while swapping (" << swapping.swaps << " swaps)\n";
+  }
+  std::cout << "Gateways awaiting reclamation: " << epochs.pendingReclaim()
+            << "\n";
+}
+
+//
+// =======================================================
+// 6. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== RCU Gateway Hot Swap Demo ===\n\n";
+
+  {
+    EpochDomain epochs;
+    CheckoutService checkout(epochs,
+                             std::make_unique<StandInGateway>("Stripe", 0.029));
+    auto scope = checkout.readerScope();
+    checkout.processCheckout(99.99, true);
+    checkout.setPaymentGateway(
+        std::make_unique<StandInGateway>("Razorpay", 0.02));
+    checkout.processCheckout(1500.0, true);
+    checkout.setPaymentGateway(
+        std::make_unique<StandInGateway>("PayPal", 0.034));
+    checkout.processCheckout(49.99, true);
+    std::cout << "Retired, not yet freed: " << epochs.pendingReclaim()
+              << "\n";
+  }
+
+  int readers = argc > 1 ? std::stoi(argv[1]) : 4;
+  std::cout << "\n=== Benchmark (" << readers
+            << " reader threads, swap every 1 ms) ===\n";
+  benchmark(readers);
+  std::cout << "Gateways still alive after shutdown: "
+            << StandInGateway::alive() << "\n";
+
+  return 0;
+}
@@ -0,0 +1,387 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Companion to interface.cpp — a fake gateway that misbehaves the same
+// way on every run of the same binary.
+//
+// Build: g++ -std=c++17 -O2 payment-gateway-simulator.cpp -o gwsim
+// Run:   ./gwsim [seed] [checkouts]   (default 42, 200,000)
+
+//
+// =======================================================
+// 1. WHY A DETERMINISTIC SIMULATOR
+// =======================================================
+//
+// Benchmarks against a live sandbox gateway are noisy: its latency,
+// error rate and throttling change minute to minute, so a 5% change in
+// p99 proves nothing. SimulatedGateway replaces it with a model:
+//
+//   latency   constant / uniform / lognormal, configurable
+//   errors    declined with probability errorRate
+//   throttle  token bucket: over the rate -> Throttled, instantly
+//   stalls    provider-wide freeze of stallLength every stallPeriod
+//
+// Same SEED -> same sequence of latencies and outcomes. With a
+// VIRTUAL clock, "waiting" only advances a counter: a million
+// checkouts with 1 ms latency take well under a second, and p99 is
+// identical on every run of the same binary against the same libm.
+//
+// All randomness is drawn from std::mt19937_64 (whose output the
+// standard fixes) and turned into doubles by hand: the std::*
+// distributions are implementation-defined and differ between
+// libstdc++ and libc++. The lognormal model still calls std::log,
+// std::exp and std::cos, which libm does not promise to round the
+// same way everywhere, so another platform or libm version may
+// shift a few latencies by a microsecond and change the digest.
+// Constant and Uniform use only correctly rounded + - * /, so they
+// match across machines (unless a compiler fuses them into FMAs).
+//
+// Profiles are checked when a gateway is built: a Uniform spread
+// above 1 would make latencies negative, and a negative double cast
+// to uint64 wraps to centuries.
+
+//
+// =======================================================
+// 2. CLOCKS: VIRTUAL OR REAL
+// =======================================================
+//
+
+class SimClock {
+public:
+  virtual ~SimClock() {}
+  virtual std::uint64_t nowUs() const = 0;
+  virtual void sleepFor(std::uint64_t us) = 0;
+};
+
+class VirtualClock : public SimClock {
+private:
+  std::uint64_t nowUs_ = 0;
+
+public:
+  std::uint64_t nowUs() const override { return nowUs_; }
+  void sleepFor(std::uint64_t us) override { nowUs_ += us; }
+};
+
+class RealClock : public SimClock {
+private:
+  std::chrono::steady_clock::time_point epoch_ =
+      std::chrono::steady_clock::now();
+
+public:
+  std::uint64_t nowUs() const override {
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - epoch_)
+                             .count());
+  }
+  void sleepFor(std::uint64_t us) override {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+  }
+};
+
+//
+// =======================================================
+// 3. THE SIMULATED GATEWAY
+// =======================================================
+//
+
+enum class PaymentStatus { Approved, Declined, Throttled };
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual PaymentStatus initiatePayment(double amount) = 0;
+  virtual std::string getProviderName() const = 0;
+};
+
+struct LatencyModel {
+  enum class Shape { Constant, Uniform, LogNormal };
+  Shape shape = Shape::LogNormal;
+  double medianUs = 1000;
+  double spread = 0.3; // Uniform: +/- fraction; LogNormal: sigma
+};
+
+struct SimulationProfile {
+  LatencyModel latency;
+  double errorRate = 0.0;
+  double throttlePerSecond = 0.0; // 0 = never throttle
+  double throttleBurst = 1.0;
+  std::uint64_t stallPeriodUs = 0; // 0 = never stall
+  std::uint64_t stallLengthUs = 0;
+};
+
+class SimulatedGateway : public PaymentGateway {
+private:
+  std::string name_;
+  SimulationProfile profile_;
+  SimClock &clock_;
+  std::mt19937_64 rng_;
+  std::uint64_t startUs_;
+  double tokens_;
+  std::uint64_t refilledUs_;
+
+  double uniform01() { return double(rng_() >> 11) * 0x1.0p-53; }
+
+  double standardNormal() { // Box-Muller, one value per call
+    double u1 = uniform01(), u2 = uniform01();
+    return std::sqrt(-2.0 * std::log(1.0 - u1)) *
+           std::cos(6.283185307179586 * u2);
+  }
+
+  std::uint64_t sampleLatencyUs() {
+    const LatencyModel &m = profile_.latency;
+    switch (m.shape) {
+    case LatencyModel::Shape::Constant:
+      return std::uint64_t(m.medianUs);
+    case LatencyModel::Shape::Uniform:
+      return std::uint64_t(m.medianUs *
+                           (1.0 + m.spread * (2.0 * uniform01() - 1.0)));
+    case LatencyModel::Shape::LogNormal:
+      // A far tail draw must not overflow the cast: cap it at an hour
+      return std::uint64_t(std::min(
+          m.medianUs * std::exp(m.spread * standardNormal()), 3.6e9));
+    }
+    return 0;
+  }
+
+  // A bad profile is a programming error in the test: stop loudly
+  static void validate(const SimulationProfile &p) {
+    const LatencyModel &m = p.latency;
+    const char *problem =
+        !(m.medianUs >= 0 && m.medianUs <= 3.6e9)
+            ? "medianUs must be in [0, 1 hour]"
+        : m.shape == LatencyModel::Shape::Uniform &&
+                !(m.spread >= 0 && m.spread <= 1)
+            ? "a Uniform spread must be in [0, 1]"
+        : m.shape == LatencyModel::Shape::LogNormal &&
+                !(m.spread >= 0 && m.spread <= 5)
+            ? "a LogNormal sigma must be in [0, 5]"
+        : !(p.errorRate >= 0 && p.errorRate <= 1)
+            ? "errorRate must be in [0, 1]"
+        : p.throttlePerSecond > 0 && !(p.throttleBurst >= 1)
+            ? "throttleBurst must be at least 1"
+        : p.stallLengthUs > p.stallPeriodUs
+            ? "stallLengthUs must not exceed stallPeriodUs"
+            : nullptr;
+    if (problem != nullptr) {
+      std::fprintf(stderr, "SimulatedGateway: %s\n", problem);
+      std::abort();
+    }
+  }
+
+  bool takeToken(std::uint64_t nowUs) {
+    if (profile_.throttlePerSecond <= 0) {
+      return true;
+    }
+    tokens_ = std::min(profile_.throttleBurst,
+                       tokens_ + double(nowUs - refilledUs_) *
+                                     profile_.throttlePerSecond / 1e6);
+    refilledUs_ = nowUs;
+    if (tokens_ < 1.0) {
+      return false;
+    }
+    tokens_ -= 1.0;
+    return true;
+  }
+
+  // Time left in the current provider-wide stall, if any
+  std::uint64_t stallRemainingUs(std::uint64_t nowUs) const {
+    if (profile_.stallPeriodUs == 0) {
+      return 0;
+    }
+    std::uint64_t into = (nowUs - startUs_) % profile_.stallPeriodUs;
+    std::uint64_t stallStart = profile_.stallPeriodUs - profile_.stallLengthUs;
+    return into >= stallStart ? profile_.stallPeriodUs - into : 0;
+  }
+
+public:
+  SimulatedGateway(const std::string &name, const SimulationProfile &profile,
+                   SimClock &clock, std::uint64_t seed)
+      : name_(name), profile_(profile), clock_(clock), rng_(seed),
+        startUs_(clock.nowUs()), tokens_(profile.throttleBurst),
+        refilledUs_(startUs_) {
+    validate(profile_);
+  }
+
+  PaymentStatus initiatePayment(double) override {
+    std::uint64_t now = clock_.nowUs();
+    if (!takeToken(now)) {
+      return PaymentStatus::Throttled; // rejected at the edge: no wait
+    }
+    // Draw every random number up front, so the sequence depends only
+    // on the number of admitted calls, never on timing
+    std::uint64_t latency = sampleLatencyUs();
+    bool declined = uniform01() < profile_.errorRate;
+    clock_.sleepFor(stallRemainingUs(now) + latency);
+    return declined ? PaymentStatus::Declined : PaymentStatus::Approved;
+  }
+
+  std::string getProviderName() const override { return name_; }
+};
+
+//
+// =======================================================
+// 4. CHECKOUT SERVICE UNDER TEST
+// =======================================================
+//
+
+class CheckoutService {
+private:
+  PaymentGateway *gateway_;
+  SimClock &clock_;
+
+public:
+  CheckoutService(PaymentGateway *gateway, SimClock &clock)
+      : gateway_(gateway), clock_(clock) {}
+
+  void setPaymentGateway(PaymentGateway *gateway) { gateway_ = gateway; }
+
+  // Retries a throttled call after 2, 4, 8 ms; gives up after 4 tries
+  PaymentStatus processCheckout(double amount) {
+    if (gateway_ == nullptr) {
+      std::cout << "⚠️  No payment gateway configured!\n";
+      return PaymentStatus::Declined;
+    }
+    PaymentStatus status = gateway_->initiatePayment(amount);
+    for (int retry = 0; retry < 3 && status == PaymentStatus::Throttled;
+         ++retry) {
+      clock_.sleepFor(2000u << retry);
+      status = gateway_->initiatePayment(amount);
+    }
+    return status;
+  }
+};
+
+//
+// =======================================================
+// 5. BENCHMARK: SAME SEED, SAME NUMBERS
+// =======================================================
+//
+// One client sends `checkouts` back to back. The gateway has a
+// lognormal ~1 ms latency, 2% declines, a 700/s throttle and a
+// 150 ms freeze every 5 s.
+
+struct RunSummary {
+  double p50Ms, p99Ms, maxMs;
+  std::size_t approved, declined, throttled;
+  std::uint64_t simulatedUs;
+  std::uint64_t digest; // fingerprint of every latency and outcome
+  double wallMs;
+};
+
+SimulationProfile benchmarkProfile() {
+  SimulationProfile p;
+  p.latency = {LatencyModel::Shape::LogNormal, 1000, 0.35};
+  p.errorRate = 0.02;
+  p.throttlePerSecond = 700;
+  p.throttleBurst = 20;
+  p.stallPeriodUs = 5000000;
+  p.stallLengthUs = 150000;
+  return p;
+}
+
+RunSummary runCheckouts(SimClock &clock, std::uint64_t seed,
+                        std::size_t checkouts) {
+  auto wallStart = std::chrono::steady_clock::now();
+  SimulatedGateway gateway("Simulated", benchmarkProfile(), clock, seed);
+  CheckoutService service(&gateway, clock);
+
+  RunSummary r{};
+  std::vector<std::uint64_t> latencies;
+  latencies.reserve(checkouts);
+  r.digest = 1469598103934665603ULL;
+  std::uint64_t start = clock.nowUs();
+  for (std::size_t i = 0; i < checkouts; ++i) {
+    std::uint64_t sent = clock.nowUs();
+    PaymentStatus status = service.processCheckout(10.0);
+    std::uint64_t us = clock.nowUs() - sent;
+    latencies.push_back(us);
+    r.digest = (r.digest ^ (us * 4 + std::uint64_t(status))) *
+               1099511628211ULL; // FNV-1a
+    if (status == PaymentStatus::Approved) {
+      ++r.approved;
+    } else if (status == PaymentStatus::Declined) {
+      ++r.declined;
+    } else {
+      ++r.throttled;
+    }
+  }
+  r.simulatedUs = clock.nowUs() - start;
+
+  std::sort(latencies.begin(), latencies.end());
+  auto pct = [&](double p) {
+    return double(latencies[std::min(latencies.size() - 1,
+                                     std::size_t(p * double(checkouts)))]) /
+           1000.0;
+  };
+  r.p50Ms = pct(0.50);
+  r.p99Ms = pct(0.99);
+  r.maxMs = double(latencies.back()) / 1000.0;
+  r.wallMs = std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - wallStart)
+                 .count();
+  return r;
+}
+
+void printRun(const char *label, const RunSummary &r) {
+  std::printf("%s\n  p50 %.2f  p99 %.2f  max %.2f ms | ok %zu  declined "
+              "%zu  throttled %zu\n  digest %016llx | %.1f s simulated in "
+              "%.1f ms wall\n",
+              label, r.p50Ms, r.p99Ms, r.maxMs, r.approved, r.declined,
+              r.throttled, (unsigned long long)r.digest,
+              double(r.simulatedUs) / 1e6, r.wallMs);
+}
+
+//
+// =======================================================
+// 6. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::uint64_t seed = argc > 1 ? std::stoull(argv[1]) : 42;
+  std::size_t checkouts = argc > 2 ? std::stoul(argv[2]) : 200000;
+
+  std::cout << "=== Deterministic Gateway Simulator Demo ===\n\n";
+  {
+    VirtualClock clock;
+    SimulationProfile flaky;
+    flaky.latency = {LatencyModel::Shape::Uniform, 800, 0.5};
+    flaky.errorRate = 0.3;
+    SimulatedGateway gateway("Stripe (simulated)", flaky, clock, seed);
+    const char *names[] = {"✅ approved", "⚠️  declined", "⏳ throttled"};
+    for (int i = 0; i < 5; ++i) {
+      std::uint64_t before = clock.nowUs();
+      PaymentStatus s = gateway.initiatePayment(25.0);
+      std::cout << "💳 " << gateway.getProviderName() << ": "
+                << names[int(s)] << " after " << clock.nowUs() - before
+                << " us (virtual)\n";
+    }
+  }
+
+  std::cout << "\n=== Benchmark (" << checkouts
+            << " checkouts, virtual time) ===\n";
+  VirtualClock first, second, third;
+  printRun("run 1, same seed:", runCheckouts(first, seed, checkouts));
+  printRun("run 2, same seed:", runCheckouts(second, seed, checkouts));
+  printRun("run 3, seed + 1:", runCheckouts(third, seed + 1, checkouts));
+
+  std::size_t realCheckouts = 2000;
+  std::cout << "\n=== Same model in real time (" << realCheckouts
+            << " checkouts) ===\n";
+  RealClock real;
+  printRun("real clock, same seed:", runCheckouts(real, seed, realCheckouts));
+  std::cout << "(real time adds sleep overshoot, so only the virtual runs "
+               "are bit-for-bit repeatable)\n";
+
+  return 0;
+}
@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Companion to interface.cpp — pick the fastest gateway, hedge the slow tail.
+//
+// Build: g++ -std=c++17 -O2 -pthread payment-hedged-router.cpp -o hedged-router
+// Run:   ./hedged-router [clients] [requestsPerClient]   (default 16 x 300)
+
+//
+// =======================================================
+// 1. ROUTING FOR THE TAIL
+// =======================================================
+//
+// With the Strategy pattern, CheckoutService uses ONE gateway. With
+// several available we can pick per request:
+//
+//   EWMA       exponentially weighted moving average of latency and
+//              error rate per gateway — cheap, adapts in seconds
+//   P2C        "power of two choices": sample two gateways at random,
+//              take the better score. Nearly as good as "always the
+//              best" but never stampedes everyone onto one provider
+//   HEDGING    if the first attempt is slower than that gateway's p95,
+//              fire a duplicate at another provider; first success wins.
+//              Costs ~5% extra calls, removes most of the slow tail.
+//
+// ⚠️ Hedging a PAYMENT can charge the customer twice. An idempotency
+//    key only dedupes within ONE provider: Stripe cannot know that
+//    PayPal already approved key 42. So when both attempts approve,
+//    the later one is REFUNDED (a compensating action) and counted as
+//    a double charge; the benchmark reports how often that happens.
+
+//
+// =======================================================
+// 2. GATEWAY INTERFACE + LATENCY-DISTRIBUTION STAND-INS
+// =======================================================
+//
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  // true = approved. The key lets THIS provider drop duplicates.
+  virtual bool initiatePayment(double amount, std::uint64_t idempotencyKey) = 0;
+  // Undo an approved payment, e.g. the losing half of a hedge
+  virtual bool refundPayment(double amount, std::uint64_t idempotencyKey) = 0;
+  virtual std::string getProviderName() const = 0;
+};
+
+struct LatencyProfile {
+  double medianMs;     // lognormal body
+  double sigma;        // lognormal spread
+  double spikeChance;  // probability of a slow outlier...
+  double spikeMs;      // ...and how slow it is
+  double errorRate;    // probability of a declined/failed call
+};
+
+class StandInGateway : public PaymentGateway {
+private:
+  std::string name_;
+  LatencyProfile profile_;
+  std::atomic<std::int64_t> netCents_{0}; // charged minus refunded
+
+public:
+  StandInGateway(const std::string &name, LatencyProfile profile)
+      : name_(name), profile_(profile) {}
+
+  bool initiatePayment(double amount, std::uint64_t) override {
+    thread_local std::mt19937_64 rng(std::random_device{}());
+    std::lognormal_distribution<double> body(std::log(profile_.medianMs),
+                                             profile_.sigma);
+    std::uniform_real_distribution<double> u(0, 1);
+    double ms = body(rng);
+    if (u(rng) < profile_.spikeChance) {
+      ms += profile_.spikeMs;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(int(ms * 1000)));
+    bool ok = u(rng) >= profile_.errorRate;
+    if (ok) {
+      netCents_ += std::llround(amount * 100);
+    }
+    return ok;
+  }
+
+  bool refundPayment(double amount, std::uint64_t) override {
+    netCents_ -= std::llround(amount * 100);
+    return true;
+  }
+
+  std::string getProviderName() const override { return name_; }
+  std::int64_t netCents() const { return netCents_.load(); }
+};
+
+//
+// =======================================================
+// 3. PER-GATEWAY HEALTH: EWMA + ROLLING p95
+// =======================================================
+//
+
+class GatewayStats {
+private:
+  static constexpr double kAlpha = 0.1; // EWMA weight of a new sample
+  static constexpr std::size_t kWindow = 256;
+
+  std::mutex mutex_;
+  double ewmaMs_ = 5.0;
+  double ewmaErrors_ = 0.0;
+  double window_[kWindow] = {};
+  std::size_t samples_ = 0;
+  std::atomic<double> p95Ms_{20.0}; // read lock-free on the hot path
+
+public:
+  void record(double ms, bool ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ewmaMs_ += kAlpha * (ms - ewmaMs_);
+    ewmaErrors_ += kAlpha * ((ok ? 0.0 : 1.0) - ewmaErrors_);
+    window_[samples_++ % kWindow] = ms;
+    if (samples_ % 32 == 0) { // refresh the percentile now and then
+      std::size_t n = std::min(samples_, kWindow);
+      std::vector<double> sorted(window_, window_ + n);
+      std::size_t k = n * 95 / 100;
+      std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+      p95Ms_.store(sorted[k]);
+    }
+  }
+
+  // Lower is better: latency inflated by the chance of having to retry
+  double score() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ewmaMs_ * (1.0 + 10.0 * ewmaErrors_);
+  }
+
+  double p95Ms() const { return p95Ms_.load(); }
+};
+
+//
+// =======================================================
+// 4. TINY THREAD POOL (attempts run concurrently)
+// =======================================================
+//
+
+class Executor {
+private:
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  bool stopping_ = false;
+
+public:
+  explicit Executor(int threads) {
+    for (int i = 0; i < threads; ++i) {
+      threads_.emplace_back([this] {
+        while (true) {
+          std::function<void()> task;
+          {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+              return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+          }
+          task();
+        }
+      });
+    }
+  }
+
+  ~Executor() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    ready_.notify_all();
+    for (auto &t : threads_) {
+      t.join();
+    }
+  }
+
+  void post(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    ready_.notify_one();
+  }
+};
+
+//
+// =======================================================
+// 5. THE ROUTER
+// =======================================================
+//
+
+enum class RoutingMode { Random, PowerOfTwo, PowerOfTwoHedged };
+
+class PaymentRouter {
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Attempt { // shared by the primary and the hedge
+    std::mutex mutex;
+    std::condition_variable done;
+    int outstanding = 0;
+    bool succeeded = false;
+    std::size_t winner = 0;
+  };
+
+  std::vector<PaymentGateway *> gateways_;
+  std::vector<std::unique_ptr<GatewayStats>> stats_;
+  Executor &executor_;
+  std::atomic<std::uint64_t> hedges_{0};
+  std::atomic<std::uint64_t> doubleCharges_{0};
+
+  // Attempts still running on the executor; they use `this`, so the
+  // destructor waits for them
+  std::mutex inflightMutex_;
+  std::condition_variable idle_;
+  int inflight_ = 0;
+
+  std::size_t randomIndex(std::size_t bound) {
+    thread_local std::mt19937 rng(std::random_device{}());
+    return std::uniform_int_distribution<std::size_t>(0, bound - 1)(rng);
+  }
+
+  // P2C: two random candidates, keep the better-scoring one.
+  // Needs at least two gateways (pay() checks).
+  std::pair<std::size_t, std::size_t> pickTwo() {
+    std::size_t a = randomIndex(gateways_.size());
+    std::size_t b = (a + 1 + randomIndex(gateways_.size() - 1)) %
+                    gateways_.size();
+    if (stats_[b]->score() < stats_[a]->score()) {
+      std::swap(a, b);
+    }
+    return {a, b}; // best first, runner-up as the hedge target
+  }
+
+  void launch(const std::shared_ptr<Attempt> &attempt, std::size_t index,
+              double amount, std::uint64_t key) {
+    {
+      std::lock_guard<std::mutex> lock(attempt->mutex);
+      ++attempt->outstanding;
+    }
+    {
+      std::lock_guard<std::mutex> lock(inflightMutex_);
+      ++inflight_;
+    }
+    executor_.post([this, attempt, index, amount, key] {
+      auto start = Clock::now();
+      bool ok = gateways_[index]->initiatePayment(amount, key);
+      double ms =
+          std::chrono::duration<double, std::milli>(Clock::now() - start)
+              .count();
+      stats_[index]->record(ms, ok);
+
+      bool duplicate;
+      {
+        std::lock_guard<std::mutex> lock(attempt->mutex);
+        --attempt->outstanding;
+        duplicate = ok && attempt->succeeded;
+        if (ok && !attempt->succeeded) {
+          attempt->succeeded = true;
+          attempt->winner = index;
+        }
+        attempt->done.notify_all();
+      }
+      if (duplicate) { // a second provider approved too: give it back
+        doubleCharges_.fetch_add(1);
+        if (!gateways_[index]->refundPayment(amount, key)) {
+          std::cout << "⚠️  Refund failed for key " << key << "\n";
+        }
+      }
+
+      std::lock_guard<std::mutex> lock(inflightMutex_);
+      if (--inflight_ == 0) {
+        idle_.notify_all();
+      }
+    });
+  }
+
+public:
+  explicit PaymentRouter(Executor &executor) : executor_(executor) {}
+
+  // Losing hedges may still be running (and refunding) after pay()
+  // has returned
+  ~PaymentRouter() {
+    std::unique_lock<std::mutex> lock(inflightMutex_);
+    idle_.wait(lock, [this] { return inflight_ == 0; });
+  }
+
+  void addGateway(PaymentGateway &gateway) {
+    gateways_.push_back(&gateway);
+    stats_.push_back(std::make_unique<GatewayStats>());
+  }
+
+  std::uint64_t hedgesSent() const { return hedges_.load(); }
+  std::uint64_t doubleCharges() const { return doubleCharges_.load(); }
+
+  // Blocks until the payment succeeds on some gateway or all attempts
+  // fail. Returns the winning provider ("" on failure).
+  std::string pay(double amount, std::uint64_t key, RoutingMode mode) {
+    if (gateways_.empty()) {
+      std::cout << "⚠️  No payment gateway configured!\n";
+      return std::string();
+    }
+    std::size_t primary, backup;
+    if (mode == RoutingMode::Random || gateways_.size() == 1) {
+      // One gateway: nothing to choose between and no one to hedge to
+      primary = randomIndex(gateways_.size());
+      backup = primary;
+    } else {
+      std::tie(primary, backup) = pickTwo();
+    }
+
+    auto attempt = std::make_shared<Attempt>();
+    launch(attempt, primary, amount, key);
+
+    std::unique_lock<std::mutex> lock(attempt->mutex);
+    if (mode == RoutingMode::PowerOfTwoHedged && backup != primary) {
+      auto hedgeAt = Clock::now() + std::chrono::microseconds(int(
+                                        stats_[primary]->p95Ms() * 1000));
+      bool settled = attempt->done.wait_until(lock, hedgeAt, [&] {
+        return attempt->succeeded || attempt->outstanding == 0;
+      });
+      if (!settled || !attempt->succeeded) {
+        // Slow past p95, or failed fast: try the runner-up too
+        lock.unlock();
+        hedges_.fetch_add(1);
+        launch(attempt, backup, amount, key);
+        lock.lock();
+      }
+    }
+    attempt->done.wait(lock, [&] {
+      return attempt->succeeded || attempt->outstanding == 0;
+    });
+    return attempt->succeeded
+               ? gateways_[attempt->winner]->getProviderName()
+               : std::string();
+  }
+};
+
+//
+// =======================================================
+// 6. BENCHMARK: p50 / p99 / p99.9 PER ROUTING MODE
+// =======================================================
+//
+
+std::int64_t totalNetCents(const std::vector<StandInGateway *> &gateways) {
+  std::int64_t total = 0;
+  for (auto *g : gateways) {
+    total += g->netCents();
+  }
+  return total;
+}
+
+void runMode(const char *label, RoutingMode mode, int clients, int perClient,
+             std::vector<StandInGateway *> &gateways) {
+  std::int64_t netBefore = totalNetCents(gateways);
+  Executor executor(clients * 2 + 4);
+  auto router = std::make_unique<PaymentRouter>(executor);
+  for (auto *g : gateways) {
+    router->addGateway(*g);
+  }
+
+  std::mutex mutex;
+  std::vector<double> latencies;
+  std::atomic<int> failures{0};
+  std::atomic<std::uint64_t> nextKey{1};
+  std::vector<std::thread> threads;
+  for (int c = 0; c < clients; ++c) {
+    threads.emplace_back([&] {
+      std::vector<double> mine;
+      for (int i = 0; i < perClient; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        if (router->pay(10.0, nextKey.fetch_add(1), mode).empty()) {
+          failures.fetch_add(1);
+        }
+        mine.push_back(std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - start)
+                           .count());
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      latencies.insert(latencies.end(), mine.begin(), mine.end());
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  auto pct = [&](double p) {
+    return latencies[std::min(latencies.size() - 1,
+                              std::size_t(p * double(latencies.size())))];
+  };
+  std::uint64_t hedges = router->hedgesSent();
+  std::uint64_t doubles = router->doubleCharges();
+  router.reset(); // waits for losing hedges to finish refunding
+
+  // Every approved checkout is charged exactly once, across providers
+  std::int64_t approved = std::int64_t(latencies.size()) - failures.load();
+  bool balanced = totalNetCents(gateways) - netBefore == approved * 1000;
+  std::cout << label << "  p50 " << pct(0.50) << " ms  p99 " << pct(0.99)
+            << " ms  p99.9 " << pct(0.999) << " ms  hedges "
+            << 100.0 * double(hedges) / double(latencies.size())
+            << "%  failures " << failures.load() << "  double charges "
+            << doubles << " (refunded) "
+            << (balanced ? "✅" : "⚠️  ledger off") << "\n";
+}
+
+void benchmark(int clients, int perClient) {
+  StandInGateway stripe("Stripe", {2.0, 0.3, 0.03, 30.0, 0.005});
+  StandInGateway razorpay("Razorpay", {3.0, 0.3, 0.02, 40.0, 0.01});
+  StandInGateway paypal("PayPal", {4.0, 0.4, 0.01, 25.0, 0.02});
+  std::vector<StandInGateway *> gateways = {&stripe, &razorpay, &paypal};
+
+  runMode("Random        ", RoutingMode::Random, clients, perClient, gateways);
+  runMode("P2C           ", RoutingMode::PowerOfTwo, clients, perClient,
+          gateways);
+  runMode("P2C + hedging ", RoutingMode::PowerOfTwoHedged, clients, perClient,
+          gateways);
+}
+
+//
+// =======================================================
+// 7. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Latency-Aware Hedged Router Demo ===\n\n";
+
+  StandInGateway fast("Stripe", {1.0, 0.2, 0.0, 0.0, 0.0});
+  StandInGateway slow("PayPal", {8.0, 0.2, 0.0, 0.0, 0.0});
+  Executor executor(4);
+  PaymentRouter router(executor);
+  router.addGateway(fast);
+  router.addGateway(slow);
+
+  // Early requests explore; EWMA quickly learns Stripe is faster
+  for (int i = 1; i <= 8; ++i) {
+    std::cout << "Checkout #" << i << " -> "
+              << router.pay(10.0 * i, std::uint64_t(i),
+                            RoutingMode::PowerOfTwoHedged)
+              << "\n";
+  }
+
+  int clients = argc > 1 ? std::stoi(argv[1]) : 16;
+  int perClient = argc > 2 ? std::stoi(argv[2]) : 300;
+  std::cout << "\n=== Benchmark (" << clients << " clients x " << perClient
+            << " checkouts) ===\n";
+  benchmark(clients, perClient);
+
+  return 0;
+}
@@ -0,0 +1,587 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Companion to interface.cpp — a retried checkout must never charge twice.
+//
+// Build: g++ -std=c++17 -O2 -pthread payment-idempotency-cache.cpp -o idem
+// Run:   ./idem [capacity] [operations]   (default 1,000,000 / 10,000,000)
+
+//
+// =======================================================
+// 1. IDEMPOTENCY KEYS
+// =======================================================
+//
+// The client sends the same key with every retry of one checkout:
+//
+//     processCheckout("order-42", 99.99)   // times out on the client
+//     processCheckout("order-42", 99.99)   // retry: must NOT pay again
+//
+// So before calling the gateway, processCheckout() asks a cache:
+//   - unseen key       -> claim it, pay, store the result
+//   - claimed, running -> "already in progress", don't pay
+//   - finished         -> return the stored result, don't pay
+//
+// Keys are stored as 128-bit fingerprints: with 64 bits, two live keys
+// colliding would make a NEW checkout replay someone else's result
+// (birthday bound: likely after ~4 billion keys, possible far sooner).
+//
+// Entries only need to live as long as clients retry (minutes), and
+// memory must stay bounded however many checkouts arrive. The cache
+// uses:
+//   - 64 SHARDS, each with its own lock -> threads rarely collide
+//   - per shard: a FIXED slab of entries + a chained hash index
+//   - per shard: a TIMING WHEEL instead of a sorted expiry structure.
+//     Slot i holds the entries expiring at tick i; advancing the clock
+//     drops whole slots. Insert, remove and expire are all O(1).
+//   - a full shard evicts the COMPLETED entry nearest expiry. A claim
+//     still in progress is never evicted (its retry would pay again);
+//     if nothing is evictable the new claim is refused with Claim::Full.
+
+//
+// =======================================================
+// 2. THE CACHE
+// =======================================================
+//
+
+enum class Claim { Fresh, InProgress, Completed, Full };
+
+// 128-bit FNV-1a of the client's key string
+struct Fingerprint {
+  std::uint64_t hi, lo;
+
+  bool operator==(const Fingerprint &o) const {
+    return hi == o.hi && lo == o.lo;
+  }
+};
+
+Fingerprint keyOf(std::string_view key) {
+  const unsigned __int128 prime =
+      (unsigned __int128)(1) << 88 | 0x13B; // 2^88 + 2^8 + 0x3b
+  unsigned __int128 h = (unsigned __int128)(0x6c62272e07bb0142ULL) << 64 |
+                        0x62b821756295c58dULL;
+  for (unsigned char c : key) {
+    h = (h ^ c) * prime;
+  }
+  return {std::uint64_t(h >> 64), std::uint64_t(h)};
+}
+
+class IdempotencyCache {
+private:
+  static constexpr std::size_t kShards = 64;
+  static constexpr std::uint32_t kWheelSlots = 256;
+  static constexpr std::int32_t kNil = -1;
+
+  struct Entry {
+    Fingerprint key;
+    std::int32_t hashNext;  // chain in the hash index
+    std::int32_t wheelPrev; // doubly linked in its wheel slot, so an
+    std::int32_t wheelNext; // entry can be unlinked in O(1)
+    std::uint32_t slot;
+    bool completed;
+    bool approved;
+  };
+
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::vector<Entry> entries; // fixed: this IS the memory bound
+    std::vector<std::int32_t> buckets;
+    std::int32_t freeList = kNil;
+    std::int32_t wheel[kWheelSlots];
+    std::uint64_t tick = 0; // last tick this shard has expired up to
+    std::uint64_t evictFrom = 0; // no live entry expires before this
+    std::size_t size = 0;
+  };
+
+  std::unique_ptr<Shard[]> shards_;
+  std::uint64_t tickMs_;
+  std::uint32_t ttlTicks_;
+  std::atomic<std::uint64_t> evictions_{0}, expirations_{0};
+
+  static std::uint64_t mix(const Fingerprint &key) { // splitmix64 finaliser
+    std::uint64_t k = key.hi ^ key.lo;
+    k ^= k >> 30;
+    k *= 0xbf58476d1ce4e5b9ULL;
+    k ^= k >> 27;
+    k *= 0x94d049bb133111ebULL;
+    return k ^ (k >> 31);
+  }
+
+  std::size_t bucketOf(const Shard &s, const Fingerprint &key) const {
+    return std::size_t(mix(key) >> 8) & (s.buckets.size() - 1);
+  }
+
+  Shard &shardOf(const Fingerprint &key) {
+    return shards_[mix(key) % kShards];
+  }
+
+  std::int32_t find(Shard &s, const Fingerprint &key) {
+    for (std::int32_t i = s.buckets[bucketOf(s, key)]; i != kNil;
+         i = s.entries[std::size_t(i)].hashNext) {
+      if (s.entries[std::size_t(i)].key == key) {
+        return i;
+      }
+    }
+    return kNil;
+  }
+
+  void unlinkWheel(Shard &s, std::int32_t i) {
+    Entry &e = s.entries[std::size_t(i)];
+    if (e.wheelPrev != kNil) {
+      s.entries[std::size_t(e.wheelPrev)].wheelNext = e.wheelNext;
+    } else {
+      s.wheel[e.slot] = e.wheelNext;
+    }
+    if (e.wheelNext != kNil) {
+      s.entries[std::size_t(e.wheelNext)].wheelPrev = e.wheelPrev;
+    }
+  }
+
+  void linkWheel(Shard &s, std::int32_t i, std::uint32_t slot) {
+    Entry &e = s.entries[std::size_t(i)];
+    e.slot = slot;
+    e.wheelPrev = kNil;
+    e.wheelNext = s.wheel[slot];
+    if (e.wheelNext != kNil) {
+      s.entries[std::size_t(e.wheelNext)].wheelPrev = i;
+    }
+    s.wheel[slot] = i;
+  }
+
+  void erase(Shard &s, std::int32_t i) {
+    Entry &e = s.entries[std::size_t(i)];
+    std::int32_t *link = &s.buckets[bucketOf(s, e.key)];
+    while (*link != i) {
+      link = &s.entries[std::size_t(*link)].hashNext;
+    }
+    *link = e.hashNext;
+    unlinkWheel(s, i);
+    e.hashNext = s.freeList;
+    s.freeList = i;
+    --s.size;
+  }
+
+  // Expire every slot the clock has passed since the last call
+  void advance(Shard &s, std::uint64_t nowTick) {
+    if (s.tick == 0 || nowTick <= s.tick) {
+      // First use, or a caller whose clock read lost a race: nothing
+      // to expire (and no unsigned underflow below)
+      s.tick = std::max(s.tick, nowTick);
+      return;
+    }
+    std::uint64_t steps = std::min<std::uint64_t>(nowTick - s.tick,
+                                                  kWheelSlots);
+    for (std::uint64_t k = 1; k <= steps; ++k) {
+      std::uint32_t slot = std::uint32_t((s.tick + k) % kWheelSlots);
+      while (s.wheel[slot] != kNil) {
+        erase(s, s.wheel[slot]);
+        expirations_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    s.tick = nowTick;
+  }
+
+  // Full shard: drop the completed entry closest to expiry, or return
+  // false if every entry is still in progress. The evictFrom cursor
+  // stops at the first non-empty slot, so skipping empty slots is
+  // amortised O(1); in-progress entries are skipped one by one, but
+  // there are only as many as checkouts in flight.
+  bool evictOldest(Shard &s) {
+    std::uint64_t t = std::max(s.evictFrom, s.tick + 1);
+    bool pinned = false; // an in-progress entry holds the cursor back
+    for (; t <= s.tick + ttlTicks_; ++t) {
+      std::uint32_t slot = std::uint32_t(t % kWheelSlots);
+      for (std::int32_t i = s.wheel[slot]; i != kNil;
+           i = s.entries[std::size_t(i)].wheelNext) {
+        if (s.entries[std::size_t(i)].completed) {
+          erase(s, i);
+          evictions_.fetch_add(1, std::memory_order_relaxed);
+          if (!pinned) {
+            s.evictFrom = t;
+          }
+          return true;
+        }
+      }
+      if (!pinned && s.wheel[slot] != kNil) {
+        s.evictFrom = t;
+        pinned = true;
+      }
+    }
+    return false;
+  }
+
+public:
+  // Keys live for ttlMs, rounded up to the wheel's tick
+  IdempotencyCache(std::size_t capacity, std::uint64_t ttlMs)
+      : shards_(new Shard[kShards]),
+        tickMs_(std::max<std::uint64_t>(1, ttlMs / (kWheelSlots - 1))),
+        ttlTicks_(std::uint32_t(std::min<std::uint64_t>(
+            kWheelSlots - 1, (ttlMs + tickMs_ - 1) / tickMs_))) {
+    std::size_t perShard = std::max<std::size_t>(1, capacity / kShards);
+    std::size_t bucketCount = 1;
+    while (bucketCount < perShard) {
+      bucketCount <<= 1;
+    }
+    for (std::size_t i = 0; i < kShards; ++i) {
+      Shard &s = shards_[i];
+      s.entries.resize(perShard);
+      s.buckets.assign(bucketCount, kNil);
+      std::fill(std::begin(s.wheel), std::end(s.wheel), kNil);
+      for (std::size_t e = 0; e < perShard; ++e) { // thread the free list
+        s.entries[e].hashNext = std::int32_t(e + 1 < perShard ? e + 1 : kNil);
+      }
+      s.freeList = 0;
+    }
+  }
+
+  // Atomically "look up or claim". On Completed, *approved holds the
+  // stored outcome. Full: the shard is all in-flight claims, retry later.
+  Claim begin(const Fingerprint &key, std::uint64_t nowMs, bool *approved) {
+    Shard &s = shardOf(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    advance(s, nowMs / tickMs_);
+
+    std::int32_t i = find(s, key);
+    if (i != kNil) {
+      const Entry &e = s.entries[std::size_t(i)];
+      if (!e.completed) {
+        return Claim::InProgress;
+      }
+      *approved = e.approved;
+      return Claim::Completed;
+    }
+
+    if (s.freeList == kNil && !evictOldest(s)) {
+      return Claim::Full;
+    }
+    i = s.freeList;
+    Entry &e = s.entries[std::size_t(i)];
+    s.freeList = e.hashNext;
+    e.key = key;
+    e.completed = false;
+    e.approved = false;
+    std::int32_t &head = s.buckets[bucketOf(s, key)];
+    e.hashNext = head;
+    head = i;
+    linkWheel(s, i, std::uint32_t((s.tick + ttlTicks_) % kWheelSlots));
+    ++s.size;
+    return Claim::Fresh;
+  }
+
+  // Record the gateway's answer for a key claimed with begin()
+  void complete(const Fingerprint &key, bool approved) {
+    Shard &s = shardOf(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::int32_t i = find(s, key);
+    if (i != kNil) {
+      s.entries[std::size_t(i)].completed = true;
+      s.entries[std::size_t(i)].approved = approved;
+    }
+  }
+
+  // The attempt failed before reaching the provider: allow a retry
+  void abandon(const Fingerprint &key) {
+    Shard &s = shardOf(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::int32_t i = find(s, key);
+    if (i != kNil) {
+      erase(s, i);
+    }
+  }
+
+  std::size_t size() {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < kShards; ++i) {
+      std::lock_guard<std::mutex> lock(shards_[i].mutex);
+      total += shards_[i].size;
+    }
+    return total;
+  }
+
+  std::size_t memoryBytes() const {
+    std::size_t total = sizeof(*this) + kShards * sizeof(Shard);
+    for (std::size_t i = 0; i < kShards; ++i) {
+      total += shards_[i].entries.capacity() * sizeof(Entry) +
+               shards_[i].buckets.capacity() * sizeof(std::int32_t);
+    }
+    return total;
+  }
+
+  std::uint64_t evictions() const { return evictions_.load(); }
+  std::uint64_t expirations() const { return expirations_.load(); }
+};
+
+//
+// =======================================================
+// 3. CHECKOUT SERVICE WITH AN IDEMPOTENCY CHECK
+// =======================================================
+//
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual bool initiatePayment(double amount) = 0; // true = approved
+  virtual std::string getProviderName() const = 0;
+};
+
+// Declines anything over the card's $10,000 limit
+class StripePayment : public PaymentGateway {
+public:
+  bool initiatePayment(double amount) override {
+    std::cout << "💳 Processing payment via Stripe: $" << amount << "\n";
+    return amount <= 10000;
+  }
+
+  std::string getProviderName() const override { return "Stripe"; }
+};
+
+using Clock = std::chrono::steady_clock;
+
+std::uint64_t nowMillis() {
+  return std::uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(
+                           Clock::now().time_since_epoch())
+                           .count());
+}
+
+class CheckoutService {
+private:
+  PaymentGateway *gateway_;
+  IdempotencyCache &cache_;
+
+public:
+  CheckoutService(PaymentGateway *gateway, IdempotencyCache &cache)
+      : gateway_(gateway), cache_(cache) {}
+
+  void setPaymentGateway(PaymentGateway *gateway) { gateway_ = gateway; }
+
+  void processCheckout(const std::string &idempotencyKey, double amount) {
+    if (gateway_ == nullptr) {
+      std::cout << "⚠️  No payment gateway configured!\n";
+      return;
+    }
+    Fingerprint key = keyOf(idempotencyKey);
+    bool approved = false;
+    switch (cache_.begin(key, nowMillis(), &approved)) {
+    case Claim::InProgress:
+      std::cout << "⏳ " << idempotencyKey << " already in progress\n";
+      return;
+    case Claim::Completed:
+      std::cout << "✅ " << idempotencyKey << " already processed, replaying "
+                << (approved ? "approval" : "decline") << "\n";
+      return;
+    case Claim::Full:
+      std::cout << "⚠️  Too many checkouts in flight, " << idempotencyKey
+                << " not charged: retry later\n";
+      return;
+    case Claim::Fresh:
+      break;
+    }
+    std::cout << "Using " << gateway_->getProviderName() << "...\n";
+    cache_.complete(key, gateway_->initiatePayment(amount));
+  }
+};
+
+//
+// =======================================================
+// 4. BASELINE: unordered_map + SORTED EXPIRY INDEX
+// =======================================================
+//
+
+class SortedExpiryCache {
+private:
+  struct Value {
+    std::uint64_t expiresMs;
+    bool completed, approved;
+  };
+  struct Hash {
+    std::size_t operator()(const Fingerprint &k) const {
+      return std::size_t(k.hi ^ k.lo);
+    }
+  };
+  std::mutex mutex_;
+  std::unordered_map<Fingerprint, Value, Hash> entries_;
+  std::multimap<std::uint64_t, Fingerprint> byExpiry_; // time -> key
+  std::size_t capacity_;
+  std::uint64_t ttlMs_;
+
+  void erase(std::multimap<std::uint64_t, Fingerprint>::iterator it) {
+    entries_.erase(it->second);
+    byExpiry_.erase(it);
+  }
+
+  // Same rule as the wheel: never evict a claim still in progress
+  bool evictOldest() {
+    for (auto it = byExpiry_.begin(); it != byExpiry_.end(); ++it) {
+      if (entries_.at(it->second).completed) {
+        erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+public:
+  SortedExpiryCache(std::size_t capacity, std::uint64_t ttlMs)
+      : capacity_(capacity), ttlMs_(ttlMs) {
+    entries_.reserve(capacity);
+  }
+
+  Claim begin(const Fingerprint &key, std::uint64_t nowMs, bool *approved) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!byExpiry_.empty() && byExpiry_.begin()->first <= nowMs) {
+      erase(byExpiry_.begin());
+    }
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      if (!it->second.completed) {
+        return Claim::InProgress;
+      }
+      *approved = it->second.approved;
+      return Claim::Completed;
+    }
+    if (entries_.size() >= capacity_ && !evictOldest()) {
+      return Claim::Full;
+    }
+    entries_.emplace(key, Value{nowMs + ttlMs_, false, false});
+    byExpiry_.emplace(nowMs + ttlMs_, key);
+    return Claim::Fresh;
+  }
+
+  void complete(const Fingerprint &key, bool approved) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      it->second.completed = true;
+      it->second.approved = approved;
+    }
+  }
+};
+
+//
+// =======================================================
+// 5. BENCHMARK: 1M-KEY CACHE UNDER CHURN
+// =======================================================
+//
+// 4 threads. Each op is begin() + complete(); 80% of keys are new
+// (churn), 20% are retries of a recent key. Virtual time advances 1 ms
+// per 1,000 ops with a 1 s TTL, so ~600k keys are live and expiring
+// at any moment. Pass a smaller capacity to exercise eviction instead.
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+template <typename Cache>
+void run(const char *label, Cache &cache, std::size_t operations) {
+  const int threads = 4;
+  std::atomic<std::uint64_t> hits{0};
+  std::vector<std::thread> pool;
+  auto start = Clock::now();
+  for (int t = 0; t < threads; ++t) {
+    pool.emplace_back([&, t] {
+      std::mt19937_64 rng(std::uint64_t(t) + 66);
+      std::uint64_t next = std::uint64_t(t) << 48, local = 0;
+      for (std::size_t i = 0; i < operations / threads; ++i) {
+        std::uint64_t id = rng() % 5 == 0 && next > 1000
+                               ? next - 1 - rng() % 1000 // a retry
+                               : next++;
+        // Real keys are hashes of client strings: spread them out too
+        Fingerprint key = keyOf(std::string_view(
+            reinterpret_cast<const char *>(&id), sizeof(id)));
+        std::uint64_t now = 1000 + (i * threads) / 1000;
+        bool approved = false;
+        if (cache.begin(key, now, &approved) == Claim::Fresh) {
+          cache.complete(key, true);
+        } else {
+          ++local;
+        }
+      }
+      hits.fetch_add(local);
+    });
+  }
+  for (auto &t : pool) {
+    t.join();
+  }
+  double ms = millisSince(start);
+  std::cout << label << ms * 1e6 / double(operations) << " ns/op, "
+            << double(operations) / ms / 1000.0 << " M ops/s, "
+            << hits.load() << " duplicates caught\n";
+}
+
+void benchmark(std::size_t capacity, std::size_t operations) {
+  const std::uint64_t ttlMs = 1000;
+  {
+    IdempotencyCache cache(capacity, ttlMs);
+    run("Sharded + timing wheel: ", cache, operations);
+    std::cout << "  live " << cache.size() << ", expired "
+              << cache.expirations() << ", evicted " << cache.evictions()
+              << ", memory " << cache.memoryBytes() / (1024 * 1024)
+              << " MB (fixed)\n";
+  }
+  {
+    SortedExpiryCache cache(capacity, ttlMs);
+    run("unordered_map + multimap: ", cache, operations);
+  }
+}
+
+//
+// =======================================================
+// 6. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Idempotency Cache Demo ===\n\n";
+
+  {
+    StripePayment stripe;
+    IdempotencyCache cache(1024, 60000);
+    CheckoutService checkout(&stripe, cache);
+    checkout.processCheckout("order-42", 99.99);
+    checkout.processCheckout("order-42", 99.99); // client retry
+    checkout.processCheckout("order-43", 15.00);
+    checkout.processCheckout("order-45", 25000.00); // over the limit
+    checkout.processCheckout("order-45", 25000.00); // replays the decline
+
+    // Two racing retries: the second sees the first still running
+    bool approved = false;
+    Fingerprint key = keyOf("order-44");
+    cache.begin(key, nowMillis(), &approved);
+    if (cache.begin(key, nowMillis(), &approved) == Claim::InProgress) {
+      std::cout << "⏳ order-44 already in progress\n";
+    }
+
+    // One entry per shard, every claim left in flight: once a key lands
+    // in an occupied shard it is refused rather than evicting a claim
+    IdempotencyCache tiny(64, 60000);
+    int claimed = 0;
+    while (tiny.begin(keyOf("order-" + std::to_string(100 + claimed)),
+                      nowMillis(), &approved) == Claim::Fresh) {
+      ++claimed;
+    }
+    std::cout << "⚠️  " << claimed << " claims in flight, next one refused "
+              << "(Claim::Full); nothing evicted: " << tiny.evictions()
+              << "\n";
+  }
+
+  std::size_t capacity = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  std::size_t operations = argc > 2 ? std::stoul(argv[2]) : 10000000;
+  std::cout << "\n=== Benchmark (" << capacity << " key capacity, "
+            << operations << " operations) ===\n";
+  benchmark(capacity, operations);
+
+  return 0;
+}
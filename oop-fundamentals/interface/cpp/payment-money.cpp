@@ -0,0 +1,406 @@
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Companion to interface.cpp — exact money amounts that format fast.
+//
+// Build: g++ -std=c++17 -O2 payment-money.cpp -o money
+// Run:   ./money [amountCount]   (default 5,000,000)
+
+//
+// =======================================================
+// 1. WHY NOT double?
+// =======================================================
+//
+//     double total = 0;
+//     for (int i = 0; i < 10; ++i) total += 0.10;
+//     total == 1.0   // false! 0.9999999999999999
+//
+// 0.10 has no exact binary representation, so every sum drifts a
+// little and receipts disagree with ledgers by a cent. Printing a
+// double is also expensive: the shortest round-trip digit search,
+// locale lookups and stream state, on every receipt line.
+//
+// Money stores an INTEGER count of minor units (cents, paise) and a
+// currency code:
+//   - + and - are exact integer ops
+//   - formatting is integer -> digits into a stack buffer, no heap
+
+//
+// =======================================================
+// 2. CURRENCIES
+// =======================================================
+//
+
+enum class Currency : std::uint8_t { USD, INR, EUR, JPY };
+
+struct CurrencyInfo {
+  const char *code;
+  const char *symbol; // UTF-8
+  std::uint8_t symbolBytes;
+  std::uint8_t decimals;  // minor-unit digits: 2 for cents, 0 for yen
+  bool indianGrouping;    // 1,23,45,678 instead of 12,345,678
+};
+
+constexpr CurrencyInfo kCurrencies[] = {
+    {"USD", "$", 1, 2, false},
+    {"INR", "₹", 3, 2, true},
+    {"EUR", "€", 3, 2, false},
+    {"JPY", "¥", 2, 0, false},
+};
+
+constexpr const CurrencyInfo &info(Currency c) {
+  return kCurrencies[std::size_t(c)];
+}
+
+//
+// =======================================================
+// 3. THE Money TYPE
+// =======================================================
+//
+
+class Money {
+private:
+  std::int64_t minor_;
+  Currency currency_;
+
+  constexpr Money(std::int64_t minor, Currency currency)
+      : minor_(minor), currency_(currency) {}
+
+  static constexpr std::int64_t scale(Currency c) {
+    return info(c).decimals == 2 ? 100 : 1;
+  }
+
+public:
+  // "-$92,233,720,368,547,758.07" plus a multi-byte symbol fits easily
+  static constexpr std::size_t kMaxFormatted = 40;
+
+  constexpr Money() : minor_(0), currency_(Currency::USD) {}
+
+  static constexpr Money fromMinor(std::int64_t minor, Currency c) {
+    return Money(minor, c);
+  }
+
+  // of(-5, 50) is -5.50: minor is a non-negative digit count and takes
+  // major's sign. Below one unit use fromMinor: fromMinor(-50) = -0.50.
+  static constexpr Money of(std::int64_t major, std::int64_t minor,
+                            Currency c) {
+    assert(minor >= 0 && minor < scale(c));
+    return Money(major * scale(c) + (major < 0 ? -minor : minor), c);
+  }
+
+  // Only at the edges (user input, legacy APIs): round once, then stay exact
+  static Money fromDouble(double major, Currency c) {
+    return Money(std::llround(major * double(scale(c))), c);
+  }
+
+  std::int64_t minorUnits() const { return minor_; }
+  Currency currency() const { return currency_; }
+  double toDouble() const { return double(minor_) / double(scale(currency_)); }
+
+  // Mixing currencies is a bug: convert first, then add
+  Money operator+(Money o) const {
+    assert(currency_ == o.currency_);
+    return Money(minor_ + o.minor_, currency_);
+  }
+  Money operator-(Money o) const {
+    assert(currency_ == o.currency_);
+    return Money(minor_ - o.minor_, currency_);
+  }
+  Money &operator+=(Money o) { return *this = *this + o; }
+  Money &operator-=(Money o) { return *this = *this - o; }
+  Money operator*(std::int64_t quantity) const {
+    return Money(minor_ * quantity, currency_);
+  }
+  bool operator==(Money o) const {
+    return minor_ == o.minor_ && currency_ == o.currency_;
+  }
+  bool operator!=(Money o) const { return !(*this == o); }
+  bool operator<(Money o) const {
+    assert(currency_ == o.currency_);
+    return minor_ < o.minor_;
+  }
+
+  // Fees and taxes in basis points (1 bp = 0.01%), rounded half away
+  // from zero — the usual rule on invoices. The product is 128-bit:
+  // minor_ * bp overflows int64 from ~$92 trillion at 10% (1,000 bp).
+  Money basisPoints(std::int64_t bp) const {
+    __int128 scaled = __int128(minor_) * bp;
+    __int128 result = (scaled + (scaled >= 0 ? 5000 : -5000)) / 10000;
+    assert(result >= INT64_MIN && result <= INT64_MAX); // only if bp > 100%
+    return Money(std::int64_t(result), currency_);
+  }
+
+  // Writes into out[0 .. kMaxFormatted) and returns the length. No
+  // heap, no locale, no floating point.
+  std::size_t formatTo(char *out) const;
+
+  // Convenience wrapper that still never allocates
+  struct Text {
+    char buffer[kMaxFormatted];
+    std::size_t length;
+    std::string_view view() const { return {buffer, length}; }
+  };
+  Text format() const {
+    Text t;
+    t.length = formatTo(t.buffer);
+    return t;
+  }
+};
+
+//
+// =======================================================
+// 4. NON-ALLOCATING FORMATTER
+// =======================================================
+//
+// Digits are produced right to left, two at a time from a 200-byte
+// table, into a scratch buffer; then sign + symbol + digits are copied
+// out. Grouping separators are inserted as the digits are written.
+
+namespace {
+
+constexpr char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+} // namespace
+
+std::size_t Money::formatTo(char *out) const {
+  const CurrencyInfo &ci = info(currency_);
+  // Negate in unsigned space so INT64_MIN is fine too
+  std::uint64_t value = minor_ < 0 ? 0 - std::uint64_t(minor_)
+                                   : std::uint64_t(minor_);
+
+  char scratch[32];
+  char *p = scratch + sizeof(scratch);
+
+  if (ci.decimals == 2) {
+    std::uint64_t cents = value % 100;
+    value /= 100;
+    p -= 2;
+    std::memcpy(p, kDigitPairs + cents * 2, 2);
+    *--p = '.';
+  }
+
+  // Integer part with grouping: first group of 3, then 3s (Western)
+  // or 2s (Indian: 12,34,56,789)
+  int group = 3;
+  int inGroup = 0;
+  do {
+    if (inGroup == group) {
+      *--p = ',';
+      inGroup = 0;
+      if (ci.indianGrouping) {
+        group = 2;
+      }
+    }
+    *--p = char('0' + value % 10);
+    value /= 10;
+    ++inGroup;
+  } while (value != 0);
+
+  std::size_t digits = std::size_t(scratch + sizeof(scratch) - p);
+  char *o = out;
+  if (minor_ < 0) {
+    *o++ = '-';
+  }
+  std::memcpy(o, ci.symbol, ci.symbolBytes);
+  o += ci.symbolBytes;
+  std::memcpy(o, p, digits);
+  return std::size_t(o - out) + digits;
+}
+
+std::ostream &operator<<(std::ostream &os, Money m) {
+  Money::Text t = m.format();
+  return os.write(t.buffer, std::streamsize(t.length));
+}
+
+//
+// =======================================================
+// 5. PAYMENT GATEWAY TAKING Money
+// =======================================================
+//
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual void initiatePayment(Money amount) = 0;
+  virtual std::string getProviderName() const = 0;
+};
+
+class StripePayment : public PaymentGateway {
+public:
+  void initiatePayment(Money amount) override {
+    std::cout << "💳 Processing payment via Stripe: " << amount << "\n";
+  }
+
+  std::string getProviderName() const override { return "Stripe"; }
+};
+
+class RazorpayPayment : public PaymentGateway {
+public:
+  void initiatePayment(Money amount) override {
+    std::cout << "💳 Processing payment via Razorpay: " << amount << "\n";
+  }
+
+  std::string getProviderName() const override { return "Razorpay"; }
+};
+
+class PayPalPayment : public PaymentGateway {
+public:
+  void initiatePayment(Money amount) override {
+    std::cout << "💳 Processing payment via PayPal: " << amount << "\n";
+  }
+
+  std::string getProviderName() const override { return "PayPal"; }
+};
+
+class CheckoutService {
+private:
+  PaymentGateway *gateway_;
+
+public:
+  explicit CheckoutService(PaymentGateway *gateway) : gateway_(gateway) {}
+
+  void setPaymentGateway(PaymentGateway *gateway) { gateway_ = gateway; }
+
+  void processCheckout(Money amount) {
+    if (gateway_ != nullptr) {
+      std::cout << "Using " << gateway_->getProviderName() << "...\n";
+      gateway_->initiatePayment(amount);
+    } else {
+      std::cout << "⚠️  No payment gateway configured!\n";
+    }
+  }
+};
+
+//
+// =======================================================
+// 6. BENCHMARK: FORMATTING THROUGHPUT
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+void report(const char *label, double ms, std::size_t count,
+            std::size_t bytes) {
+  std::cout << label << ms << " ms (" << ms * 1e6 / double(count)
+            << " ns/amount, " << bytes << " bytes)\n";
+}
+
+void benchmark(std::size_t count) {
+  std::mt19937_64 rng(63);
+  std::uniform_int_distribution<std::int64_t> cents(0, 100000000);
+  std::vector<Money> amounts;
+  std::vector<double> doubles;
+  amounts.reserve(count);
+  doubles.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    Money m = Money::fromMinor(cents(rng), i % 2 ? Currency::INR
+                                                  : Currency::USD);
+    amounts.push_back(m);
+    doubles.push_back(m.toDouble());
+  }
+
+  // Baseline: what receipts do today — stream the double
+  std::size_t bytes = 0;
+  std::ostringstream os;
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    os.str("");
+    os << (i % 2 ? "₹" : "$") << std::fixed << std::setprecision(2)
+       << doubles[i];
+    bytes += os.str().size();
+  }
+  report("ostream << double:        ", millisSince(start), count, bytes);
+
+  bytes = 0;
+  char buffer[64];
+  start = Clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    bytes += std::size_t(std::snprintf(buffer, sizeof(buffer), "%s%.2f",
+                                       i % 2 ? "₹" : "$", doubles[i]));
+  }
+  report("snprintf(\"%.2f\"):         ", millisSince(start), count, bytes);
+
+  bytes = 0;
+  start = Clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    auto r = std::to_chars(buffer, buffer + sizeof(buffer), doubles[i],
+                           std::chars_format::fixed, 2);
+    bytes += std::size_t(r.ptr - buffer);
+  }
+  report("to_chars(double), no sym: ", millisSince(start), count, bytes);
+
+  // Money also adds thousands separators, which the others skip
+  bytes = 0;
+  start = Clock::now();
+  for (const Money &m : amounts) {
+    bytes += m.formatTo(buffer);
+  }
+  report("Money::formatTo:          ", millisSince(start), count, bytes);
+}
+
+//
+// =======================================================
+// 7. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Fixed-Point Money Demo ===\n\n";
+
+  double d = 0;
+  Money m = Money::fromMinor(0, Currency::USD);
+  for (int i = 0; i < 1000000; ++i) {
+    d += 0.10;
+    m += Money::of(0, 10, Currency::USD);
+  }
+  std::cout << std::setprecision(17) << "1M x 0.10 as double: " << d << "\n"
+            << "1M x 0.10 as Money:  " << m << "\n\n";
+
+  Money price = Money::of(1234567, 89, Currency::INR);
+  std::cout << "Indian grouping:  " << price << "\n"
+            << "2.9% fee on $19.99: "
+            << Money::of(19, 99, Currency::USD).basisPoints(290) << "\n"
+            << "Refund:           "
+            << Money::of(5, 0, Currency::EUR) - Money::of(12, 50, Currency::EUR)
+            << "\n"
+            << "of(-5, 50):       " << Money::of(-5, 50, Currency::USD)
+            << "\n"
+            << "Yen (no decimals): " << Money::of(98000, 0, Currency::JPY)
+            << "\n\n";
+
+  StripePayment stripe;
+  RazorpayPayment razorpay;
+  CheckoutService checkout(&stripe);
+  checkout.processCheckout(Money::of(99, 99, Currency::USD));
+  checkout.setPaymentGateway(&razorpay);
+  checkout.processCheckout(Money::of(150000, 0, Currency::INR));
+
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 5000000;
+  std::cout << std::setprecision(6) << "\n=== Benchmark (" << count
+            << " amounts) ===\n";
+  benchmark(count);
+
+  return 0;
+}
@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Companion to interface.cpp — send the net amount, not every transfer.
+//
+// Build: g++ -std=c++17 -O2 payment-netting.cpp -o netting
+// Run:   ./netting [transfersPerSecond]   (default 20,000 for 60 s)
+
+//
+// =======================================================
+// 1. NETTING
+// =======================================================
+//
+// Two parties trading small amounts back and forth:
+//
+//     Alice -> Bob   $3.00
+//     Bob   -> Alice $1.25
+//     Alice -> Bob   $0.50
+//
+// Three gateway calls, three fees. Over a short WINDOW only the net
+// matters: Alice -> Bob $2.25, one call. If the flows cancel exactly,
+// no call at all.
+//
+// Trade-off: a transfer now waits until its window closes, so the
+// added latency is window/2 on average and a whole window at worst.
+// The benchmark sweeps window sizes to show both sides.
+//
+// Amounts are integer cents (see payment-money.cpp): netting adds and
+// subtracts many amounts, and doubles would drift.
+
+//
+// =======================================================
+// 2. GATEWAY (as in interface.cpp) + A COUNTING STAND-IN
+// =======================================================
+//
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual void initiatePayment(double amount) = 0;
+  virtual std::string getProviderName() const = 0;
+};
+
+class StripePayment : public PaymentGateway {
+public:
+  void initiatePayment(double amount) override {
+    std::cout << "💳 Processing payment via Stripe: $" << amount << "\n";
+  }
+
+  std::string getProviderName() const override { return "Stripe"; }
+};
+
+// Counts calls and volume instead of printing
+class CountingGateway : public PaymentGateway {
+private:
+  std::uint64_t calls_ = 0;
+  double volume_ = 0;
+
+public:
+  void initiatePayment(double amount) override {
+    ++calls_;
+    volume_ += amount;
+  }
+
+  std::string getProviderName() const override { return "Counting"; }
+  std::uint64_t calls() const { return calls_; }
+  double volume() const { return volume_; }
+};
+
+//
+// =======================================================
+// 3. THE NETTING ENGINE
+// =======================================================
+//
+
+using PartyId = std::uint32_t;
+
+struct Transfer {
+  PartyId payer;
+  PartyId payee;
+  std::int64_t cents;
+};
+
+class NettingEngine {
+private:
+  PaymentGateway &gateway_;
+  std::uint64_t windowUs_;
+  std::uint64_t windowEnd_ = 0;
+
+  // One entry per UNORDERED pair: key = (low id, high id). Positive
+  // net means low pays high, negative means high pays low.
+  std::unordered_map<std::uint64_t, std::int64_t> net_;
+
+  // Latency bookkeeping without a per-transfer record: every transfer
+  // in a window settles at windowEnd_, so sum(latency) =
+  // count * windowEnd_ - sum(arrival)
+  std::uint64_t windowCount_ = 0;
+  std::uint64_t windowArrivalSum_ = 0;
+  std::uint64_t windowFirstArrival_ = 0;
+
+  std::uint64_t submitted_ = 0, calls_ = 0;
+  double latencySumUs_ = 0, maxLatencyUs_ = 0;
+
+  static std::uint64_t pairKey(PartyId a, PartyId b) {
+    return std::uint64_t(std::min(a, b)) << 32 | std::max(a, b);
+  }
+
+  void send(PartyId payer, PartyId payee, std::int64_t cents) {
+    (void)payer; // a real gateway call would carry both parties
+    (void)payee;
+    gateway_.initiatePayment(double(cents) / 100.0);
+    ++calls_;
+  }
+
+  void closeWindow() {
+    for (const auto &[key, cents] : net_) {
+      if (cents == 0) {
+        continue; // flows cancelled out: nothing to send at all
+      }
+      auto low = PartyId(key >> 32), high = PartyId(key);
+      if (cents > 0) {
+        send(low, high, cents);
+      } else {
+        send(high, low, -cents);
+      }
+    }
+    net_.clear();
+    if (windowCount_ > 0) {
+      latencySumUs_ += double(windowCount_ * windowEnd_ - windowArrivalSum_);
+      maxLatencyUs_ = std::max(maxLatencyUs_,
+                               double(windowEnd_ - windowFirstArrival_));
+    }
+    windowCount_ = windowArrivalSum_ = 0;
+  }
+
+public:
+  // window = 0 disables netting: every transfer goes straight through
+  NettingEngine(PaymentGateway &gateway, std::chrono::microseconds window)
+      : gateway_(gateway), windowUs_(std::uint64_t(window.count())) {}
+
+  // Close every window that ended before `nowUs` (a timer in a real
+  // service; the simulation calls it on each arrival)
+  void advance(std::uint64_t nowUs) {
+    if (windowUs_ == 0) {
+      return;
+    }
+    if (windowEnd_ == 0) {
+      windowEnd_ = nowUs - nowUs % windowUs_ + windowUs_;
+    }
+    while (nowUs >= windowEnd_) {
+      closeWindow();
+      windowEnd_ += windowUs_;
+    }
+  }
+
+  void submit(const Transfer &t, std::uint64_t nowUs) {
+    ++submitted_;
+    if (windowUs_ == 0) {
+      send(t.payer, t.payee, t.cents);
+      return;
+    }
+    advance(nowUs);
+    std::int64_t &net = net_[pairKey(t.payer, t.payee)];
+    net += t.payer < t.payee ? t.cents : -t.cents;
+    if (windowCount_++ == 0) {
+      windowFirstArrival_ = nowUs;
+    }
+    windowArrivalSum_ += nowUs;
+  }
+
+  void flush() {
+    if (windowUs_ != 0) {
+      closeWindow();
+    }
+  }
+
+  std::uint64_t submitted() const { return submitted_; }
+  std::uint64_t gatewayCalls() const { return calls_; }
+  double meanAddedLatencyMs() const {
+    return submitted_ ? latencySumUs_ / double(submitted_) / 1000.0 : 0.0;
+  }
+  double maxAddedLatencyMs() const { return maxLatencyUs_ / 1000.0; }
+};
+
+//
+// =======================================================
+// 4. BENCHMARK: CALLS SAVED vs LATENCY ADDED
+// =======================================================
+//
+// 60 simulated seconds of micro-transfers between 10,000 parties.
+// Pairs are skewed (a few pairs trade constantly, most rarely) and
+// each transfer goes either way with equal probability.
+
+std::vector<Transfer> makeWorkload(std::size_t count) {
+  const PartyId parties = 10000;
+  const std::size_t pairs = 50000;
+  std::mt19937_64 rng(67);
+  std::uniform_real_distribution<double> u(0, 1);
+  std::uniform_int_distribution<PartyId> party(0, parties - 1);
+  std::uniform_int_distribution<std::int64_t> cents(1, 500);
+
+  std::vector<std::pair<PartyId, PartyId>> pairTable(pairs);
+  for (auto &p : pairTable) {
+    p.first = party(rng);
+    do {
+      p.second = party(rng);
+    } while (p.second == p.first);
+  }
+
+  std::vector<Transfer> transfers(count);
+  for (auto &t : transfers) {
+    // u^3 skews towards low indices: hot pairs
+    const auto &p = pairTable[std::size_t(std::pow(u(rng), 3.0) * pairs)];
+    bool forward = rng() & 1;
+    t = {forward ? p.first : p.second, forward ? p.second : p.first,
+         cents(rng)};
+  }
+  return transfers;
+}
+
+void benchmark(std::size_t perSecond) {
+  const std::size_t seconds = 60;
+  std::vector<Transfer> transfers = makeWorkload(perSecond * seconds);
+  const double gapUs = 1e6 / double(perSecond);
+
+  std::printf("%-10s %12s %10s %14s %14s %12s\n", "window", "gw calls",
+              "saved", "mean +latency", "max +latency", "engine ns");
+  for (long windowMs : {0L, 10L, 100L, 1000L, 10000L}) {
+    CountingGateway gateway;
+    NettingEngine engine(gateway, std::chrono::milliseconds(windowMs));
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < transfers.size(); ++i) {
+      engine.submit(transfers[i], 1 + std::uint64_t(double(i) * gapUs));
+    }
+    engine.flush();
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start)
+                    .count() /
+                double(transfers.size());
+
+    char label[16];
+    std::snprintf(label, sizeof(label), windowMs ? "%ld ms" : "off",
+                  windowMs);
+    std::printf("%-10s %12llu %9.1f%% %11.2f ms %11.2f ms %12.1f\n", label,
+                (unsigned long long)engine.gatewayCalls(),
+                100.0 * (1.0 - double(engine.gatewayCalls()) /
+                                   double(engine.submitted())),
+                engine.meanAddedLatencyMs(), engine.maxAddedLatencyMs(), ns);
+  }
+}
+
+//
+// =======================================================
+// 5. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Payment Netting Demo ===\n\n";
+
+  const PartyId alice = 1, bob = 2, carol = 3;
+  StripePayment stripe;
+  NettingEngine engine(stripe, std::chrono::seconds(1));
+  engine.submit({alice, bob, 300}, 100);    // Alice -> Bob   $3.00
+  engine.submit({bob, alice, 125}, 200);    // Bob   -> Alice $1.25
+  engine.submit({alice, bob, 50}, 300);     // Alice -> Bob   $0.50
+  engine.submit({carol, bob, 1000}, 400);   // Carol -> Bob   $10.00
+  engine.submit({bob, carol, 1000}, 500);   // Bob   -> Carol $10.00
+  std::cout << "5 transfers submitted, window closes after 1 s:\n";
+  engine.advance(1000000);
+  std::cout << "Gateway calls: " << engine.gatewayCalls()
+            << " (Carol/Bob cancelled out)\n";
+
+  std::size_t perSecond = argc > 1 ? std::stoul(argv[1]) : 20000;
+  std::cout << "\n=== Benchmark (" << perSecond
+            << " transfers/s for 60 s, 10,000 parties) ===\n";
+  benchmark(perSecond);
+
+  return 0;
+}
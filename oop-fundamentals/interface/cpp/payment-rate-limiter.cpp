@@ -0,0 +1,362 @@
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Companion to interface.cpp — respect each provider's quota, cheaply.
+//
+// Build: g++ -std=c++17 -O2 -pthread payment-rate-limiter.cpp -o rate-limiter
+// Run:   ./rate-limiter [threads]   (default 64)
+
+//
+// =======================================================
+// 1. TOKEN BUCKETS, AND WHY ONE COUNTER IS NOT ENOUGH
+// =======================================================
+//
+// A provider allows R requests/second with bursts up to B. A token
+// bucket models that exactly: it holds at most B tokens, gains R per
+// second, and each initiatePayment() must take one.
+//
+// The naive version is a mutex + (tokens, lastRefill). Under many
+// threads every checkout serialises on that lock and its cache line.
+//
+// Two-level design:
+//
+//     [ global pool: atomic tokens, refilled by time ]
+//          ▲ borrow a chunk        ▲
+//     [ core 0 shard ]  ...  [ core N shard ]   one cache line each
+//          ▲                       ▲
+//       checkouts on core 0     checkouts on core N
+//
+// Most admissions touch only the local shard. The global counter is
+// hit once per chunk, and chunks shrink when tokens get scarce so idle
+// cores cannot hoard the quota.
+
+//
+// =======================================================
+// 2. GLOBAL POOL (LOCK-FREE, TIME-REFILLED)
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+std::int64_t nowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+class TokenPool {
+private:
+  const std::int64_t ratePerSec_;
+  const std::int64_t burst_;
+  const std::int64_t fillNs_; // time to refill an empty bucket
+  alignas(64) std::atomic<std::int64_t> tokens_;
+  alignas(64) std::atomic<std::int64_t> lastRefill_; // ns
+
+  // Whoever wins the CAS on lastRefill_ credits the elapsed time. The
+  // clock advances only by the time actually converted into whole
+  // tokens, so fractions are never lost. A long idle gap is clamped to
+  // fillNs_ first (so elapsed * rate cannot overflow), and once the
+  // bucket is full the clock jumps to now: idle time is not banked.
+  void refill() {
+    std::int64_t last = lastRefill_.load(std::memory_order_relaxed);
+    std::int64_t now = nowNanos();
+    std::int64_t elapsed = std::min(now - last, fillNs_);
+    std::int64_t earned = std::int64_t(__int128(elapsed) * ratePerSec_ /
+                                       1000000000);
+    if (earned <= 0) {
+      return;
+    }
+    bool full = elapsed == fillNs_ ||
+                tokens_.load(std::memory_order_relaxed) + earned >= burst_;
+    std::int64_t advanced =
+        full ? now
+             : last + std::int64_t(__int128(earned) * 1000000000 /
+                                   ratePerSec_);
+    if (!lastRefill_.compare_exchange_strong(last, advanced)) {
+      return; // another thread refilled
+    }
+    std::int64_t t = tokens_.load();
+    std::int64_t next;
+    do {
+      next = std::min(burst_, t + earned); // a full bucket discards
+    } while (!tokens_.compare_exchange_weak(t, next));
+  }
+
+public:
+  TokenPool(std::int64_t ratePerSec, std::int64_t burst)
+      : ratePerSec_(ratePerSec), burst_(burst),
+        fillNs_(std::int64_t((__int128(burst) * 1000000000 + ratePerSec - 1) /
+                             ratePerSec)),
+        tokens_(burst), lastRefill_(nowNanos()) {}
+
+  // Takes between 1 and `want` tokens; returns how many (0 = empty)
+  std::int64_t take(std::int64_t want) {
+    for (int attempt = 0;; ++attempt) {
+      std::int64_t t = tokens_.load(std::memory_order_relaxed);
+      while (t > 0) {
+        std::int64_t got = std::min(want, t);
+        if (tokens_.compare_exchange_weak(t, t - got)) {
+          return got;
+        }
+      }
+      if (attempt == 1) {
+        return 0; // still empty after crediting elapsed time
+      }
+      refill();
+    }
+  }
+
+  std::int64_t available() const {
+    return tokens_.load(std::memory_order_relaxed);
+  }
+};
+
+//
+// =======================================================
+// 3. PER-CORE SHARDS THAT BORROW FROM THE POOL
+// =======================================================
+//
+
+class ShardedTokenBucket {
+private:
+  static constexpr std::int64_t kMaxBorrow = 64;
+
+  struct alignas(64) Shard { // one cache line: no false sharing
+    std::atomic<std::int64_t> tokens{0};
+  };
+
+  TokenPool pool_;
+  std::size_t shardCount_;
+  std::unique_ptr<Shard[]> shards_;
+
+  Shard &localShard() {
+    int cpu = sched_getcpu(); // vDSO: a few ns, no syscall
+    return shards_[std::size_t(cpu < 0 ? 0 : cpu) % shardCount_];
+  }
+
+public:
+  ShardedTokenBucket(std::int64_t ratePerSec, std::int64_t burst)
+      : pool_(ratePerSec, burst),
+        shardCount_(std::max(1u, std::thread::hardware_concurrency())),
+        shards_(new Shard[shardCount_]) {}
+
+  bool tryAcquire() {
+    Shard &shard = localShard();
+    std::int64_t t = shard.tokens.load(std::memory_order_relaxed);
+    while (t > 0) { // fast path: only this core's cache line
+      if (shard.tokens.compare_exchange_weak(t, t - 1,
+                                             std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    // Borrow less when the pool runs low, so one busy core cannot
+    // strand the whole quota in its shard
+    std::int64_t fair =
+        pool_.available() / std::int64_t(2 * shardCount_);
+    std::int64_t got = pool_.take(std::clamp<std::int64_t>(fair, 1,
+                                                          kMaxBorrow));
+    if (got == 0) {
+      return false;
+    }
+    shard.tokens.fetch_add(got - 1, std::memory_order_relaxed);
+    return true;
+  }
+};
+
+// Baselines for the benchmark
+class MutexTokenBucket {
+private:
+  std::mutex mutex_;
+  double tokens_, rate_, burst_;
+  Clock::time_point last_ = Clock::now();
+
+public:
+  MutexTokenBucket(std::int64_t ratePerSec, std::int64_t burst)
+      : tokens_(double(burst)), rate_(double(ratePerSec)),
+        burst_(double(burst)) {}
+
+  bool tryAcquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    tokens_ = std::min(burst_,
+                       tokens_ + rate_ * std::chrono::duration<double>(
+                                             now - last_).count());
+    last_ = now;
+    if (tokens_ < 1.0) {
+      return false;
+    }
+    tokens_ -= 1.0;
+    return true;
+  }
+};
+
+class GlobalOnlyTokenBucket { // the pool alone: one shared atomic
+private:
+  TokenPool pool_;
+
+public:
+  GlobalOnlyTokenBucket(std::int64_t ratePerSec, std::int64_t burst)
+      : pool_(ratePerSec, burst) {}
+
+  bool tryAcquire() { return pool_.take(1) == 1; }
+};
+
+//
+// =======================================================
+// 4. A RATE-LIMITED GATEWAY (DECORATOR)
+// =======================================================
+//
+// The limiter wraps any PaymentGateway, so Stripe, Razorpay and PayPal
+// each get their own quota without changing their code.
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  // false = not sent (throttled) or declined
+  virtual bool initiatePayment(double amount) = 0;
+  virtual std::string getProviderName() const = 0;
+};
+
+class StripePayment : public PaymentGateway {
+public:
+  bool initiatePayment(double amount) override {
+    std::cout << "💳 Processing payment via Stripe: $" << amount << "\n";
+    return true;
+  }
+
+  std::string getProviderName() const override { return "Stripe"; }
+};
+
+class RateLimitedGateway : public PaymentGateway {
+private:
+  PaymentGateway &inner_;
+  ShardedTokenBucket bucket_;
+
+public:
+  RateLimitedGateway(PaymentGateway &inner, std::int64_t ratePerSec,
+                     std::int64_t burst)
+      : inner_(inner), bucket_(ratePerSec, burst) {}
+
+  bool initiatePayment(double amount) override {
+    if (!bucket_.tryAcquire()) {
+      std::cout << "⚠️  " << inner_.getProviderName()
+                << " quota exceeded, retry later\n";
+      return false;
+    }
+    return inner_.initiatePayment(amount);
+  }
+
+  std::string getProviderName() const override {
+    return inner_.getProviderName();
+  }
+};
+
+//
+// =======================================================
+// 5. BENCHMARK: ADMISSION COST AT N THREADS
+// =======================================================
+//
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+template <typename Bucket>
+void run(const char *label, Bucket &bucket, int threads,
+         std::int64_t allowedRate, std::int64_t burst) {
+  const auto duration = std::chrono::milliseconds(500);
+  std::atomic<bool> stop{false};
+  std::atomic<std::uint64_t> checks{0}, admitted{0};
+  std::vector<std::thread> pool;
+  auto start = Clock::now();
+  for (int i = 0; i < threads; ++i) {
+    pool.emplace_back([&] {
+      std::uint64_t c = 0, a = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        a += bucket.tryAcquire();
+        ++c;
+      }
+      checks.fetch_add(c);
+      admitted.fetch_add(a);
+    });
+  }
+  std::this_thread::sleep_for(duration);
+  stop.store(true);
+  for (auto &t : pool) {
+    t.join();
+  }
+  double ms = millisSince(start);
+  // Upper bound a correct limiter may admit in this time
+  double limit = double(burst) + double(allowedRate) * ms / 1000.0;
+  std::cout << label << ms * 1e6 / double(checks.load())
+            << " ns/check (wall), admitted " << admitted.load() << " of max "
+            << std::int64_t(limit) << "\n";
+}
+
+void benchmark(int threads) {
+  // Generous quota: most checks succeed, measures the fast path
+  const std::int64_t rate = 20000000, burst = 100000;
+  {
+    MutexTokenBucket b(rate, burst);
+    run("std::mutex bucket:    ", b, threads, rate, burst);
+  }
+  {
+    GlobalOnlyTokenBucket b(rate, burst);
+    run("single atomic pool:   ", b, threads, rate, burst);
+  }
+  {
+    ShardedTokenBucket b(rate, burst);
+    run("per-core shards:      ", b, threads, rate, burst);
+  }
+
+  // Tight quota: most checks are rejected, verifies accuracy
+  std::cout << "Throttled at 100k/s:\n";
+  const std::int64_t tight = 100000, tightBurst = 1000;
+  {
+    MutexTokenBucket b(tight, tightBurst);
+    run("std::mutex bucket:    ", b, threads, tight, tightBurst);
+  }
+  {
+    ShardedTokenBucket b(tight, tightBurst);
+    run("per-core shards:      ", b, threads, tight, tightBurst);
+  }
+}
+
+//
+// =======================================================
+// 6. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Token-Bucket Rate Limiter Demo ===\n\n";
+
+  StripePayment stripe;
+  RateLimitedGateway limited(stripe, 2, 3); // 2/s, bursts of 3
+  for (int i = 1; i <= 5; ++i) {
+    limited.initiatePayment(10.0 * i);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(600));
+  std::cout << "...600 ms later (one token refilled):\n";
+  limited.initiatePayment(60.0);
+  limited.initiatePayment(70.0);
+
+  int threads = argc > 1 ? std::stoi(argv[1]) : 64;
+  std::cout << "\n=== Benchmark (" << threads << " threads, "
+            << std::thread::hardware_concurrency() << " cores) ===\n";
+  benchmark(threads);
+
+  return 0;
+}
@@ -0,0 +1,378 @@
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Companion to interface.cpp — one CheckoutService per core, nothing shared.
+//
+// Build: g++ -std=c++17 -O2 -pthread payment-sharded-checkout.cpp -o sharded
+// Run:   ./sharded [checkouts] [maxShards]   (default 2,000,000 / 2 x cores)
+
+//
+// =======================================================
+// 1. SHARED-NOTHING
+// =======================================================
+//
+// A CheckoutService with state (per-customer ledger, counters) shared
+// by all threads needs a lock. Every checkout then bounces the lock's
+// cache line and the ledger's lines between cores, and adding cores
+// adds contention, not throughput.
+//
+// Shared-nothing turns that around:
+//
+//   submit(customer 17) ──hash──▶ shard 1 inbox ──▶ shard 1 thread
+//   submit(customer 42) ──hash──▶ shard 3 inbox ──▶ shard 3 thread
+//                                                   (pinned to core 3,
+//                                                    owns its service,
+//                                                    gateway and ledger)
+//
+//   - a customer always lands on the same shard, so its state needs
+//     no lock: only one thread ever touches it
+//   - the only cross-core traffic is the message in the inbox
+//   - shards never talk to each other, so throughput scales with cores
+
+//
+// =======================================================
+// 2. GATEWAY + CHECKOUT SERVICE (single-threaded by design)
+// =======================================================
+//
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual void initiatePayment(double amount) = 0;
+  virtual std::string getProviderName() const = 0;
+};
+
+// Stands in for per-payment CPU work (signing, fraud scoring): ~200 ns
+class StandInGateway : public PaymentGateway {
+private:
+  std::uint64_t signature_ = 0;
+
+public:
+  void initiatePayment(double amount) override {
+    std::uint64_t h = std::uint64_t(amount * 100) ^ signature_;
+    for (int i = 0; i < 64; ++i) {
+      h = (h ^ (h >> 29)) * 0xbf58476d1ce4e5b9ULL;
+    }
+    signature_ = h;
+  }
+
+  std::string getProviderName() const override { return "Stripe"; }
+  std::uint64_t signature() const { return signature_; }
+};
+
+using CustomerId = std::uint64_t;
+
+class CheckoutService {
+private:
+  PaymentGateway *gateway_;
+  std::unordered_map<CustomerId, double> spentByCustomer_;
+  std::uint64_t checkouts_ = 0;
+
+public:
+  explicit CheckoutService(PaymentGateway *gateway) : gateway_(gateway) {}
+
+  void setPaymentGateway(PaymentGateway *gateway) { gateway_ = gateway; }
+
+  void processCheckout(CustomerId customer, double amount) {
+    if (gateway_ == nullptr) {
+      std::cout << "⚠️  No payment gateway configured!\n";
+      return;
+    }
+    gateway_->initiatePayment(amount);
+    spentByCustomer_[customer] += amount;
+    ++checkouts_;
+  }
+
+  double spentBy(CustomerId customer) const {
+    auto it = spentByCustomer_.find(customer);
+    return it != spentByCustomer_.end() ? it->second : 0.0;
+  }
+  std::uint64_t checkouts() const { return checkouts_; }
+};
+
+//
+// =======================================================
+// 3. INBOX: BOUNDED MULTI-PRODUCER QUEUE (Vyukov)
+// =======================================================
+//
+// Each cell carries a sequence number saying whose turn it is, so
+// producers claim cells with one CAS on the tail and the single
+// consumer needs no CAS at all.
+
+struct CheckoutRequest {
+  CustomerId customer;
+  double amount;
+};
+
+class Inbox {
+private:
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    CheckoutRequest request;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  std::size_t mask_;
+  alignas(64) std::atomic<std::size_t> tail_{0}; // producers
+  alignas(64) std::size_t head_ = 0;             // the shard thread
+
+public:
+  explicit Inbox(std::size_t capacityPow2)
+      : cells_(new Cell[capacityPow2]), mask_(capacityPow2 - 1) {
+    for (std::size_t i = 0; i < capacityPow2; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool tryPush(const CheckoutRequest &r) {
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = cells_[pos & mask_];
+      std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+      auto diff = std::intptr_t(seq) - std::intptr_t(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          cell.request = r;
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false; // full
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool tryPop(CheckoutRequest &out) {
+    Cell &cell = cells_[head_ & mask_];
+    if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) {
+      return false; // empty (or a producer is mid-write)
+    }
+    out = cell.request;
+    cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+    ++head_;
+    return true;
+  }
+};
+
+//
+// =======================================================
+// 4. THE SHARDED SERVICE
+// =======================================================
+//
+
+bool pinToCore(std::thread &thread, unsigned core) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core, &set);
+  return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) ==
+         0;
+}
+
+class ShardedCheckoutService {
+private:
+  struct Shard {
+    StandInGateway gateway;
+    CheckoutService service{&gateway};
+    Inbox inbox{1 << 14};
+    alignas(64) std::atomic<std::uint64_t> processed{0};
+    std::thread thread;
+  };
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<bool> stopping_{false};
+
+  static std::uint64_t hashCustomer(CustomerId id) { // splitmix64
+    id = (id ^ (id >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    id = (id ^ (id >> 27)) * 0x94d049bb133111ebULL;
+    return id ^ (id >> 31);
+  }
+
+  void runShard(Shard &shard) {
+    CheckoutRequest r;
+    while (true) {
+      std::uint64_t done = 0;
+      while (shard.inbox.tryPop(r)) {
+        shard.service.processCheckout(r.customer, r.amount);
+        ++done;
+      }
+      if (done > 0) {
+        shard.processed.fetch_add(done, std::memory_order_release);
+      } else if (stopping_.load(std::memory_order_acquire)) {
+        return;
+      } else {
+        std::this_thread::yield(); // idle: let producers run
+      }
+    }
+  }
+
+public:
+  explicit ShardedCheckoutService(std::size_t shardCount) {
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t i = 0; i < shardCount; ++i) {
+      shards_.push_back(std::make_unique<Shard>());
+    }
+    for (std::size_t i = 0; i < shardCount; ++i) {
+      Shard &shard = *shards_[i];
+      shard.thread = std::thread([this, &shard] { runShard(shard); });
+      if (!pinToCore(shard.thread, unsigned(i % cores))) {
+        std::cout << "⚠️  Could not pin shard " << i << "\n";
+      }
+    }
+  }
+
+  ~ShardedCheckoutService() {
+    stopping_.store(true, std::memory_order_release);
+    for (auto &s : shards_) {
+      s->thread.join();
+    }
+  }
+
+  std::size_t shardFor(CustomerId customer) const {
+    return std::size_t(hashCustomer(customer) % shards_.size());
+  }
+
+  // Callable from any thread; blocks (yielding) only if the inbox is full
+  void processCheckout(CustomerId customer, double amount) {
+    Inbox &inbox = shards_[shardFor(customer)]->inbox;
+    while (!inbox.tryPush({customer, amount})) {
+      std::this_thread::yield();
+    }
+  }
+
+  std::uint64_t processed() const {
+    std::uint64_t total = 0;
+    for (const auto &s : shards_) {
+      total += s->processed.load(std::memory_order_acquire);
+    }
+    return total;
+  }
+
+  // Safe once processed() covers everything submitted for this customer
+  double spentBy(CustomerId customer) const {
+    return shards_[shardFor(customer)]->service.spentBy(customer);
+  }
+};
+
+// Baseline: one service for everyone, behind a mutex
+class LockedCheckoutService {
+private:
+  std::mutex mutex_;
+  StandInGateway gateway_;
+  CheckoutService service_{&gateway_};
+
+public:
+  void processCheckout(CustomerId customer, double amount) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    service_.processCheckout(customer, amount);
+  }
+};
+
+//
+// =======================================================
+// 5. BENCHMARK: SCALING WITH SHARD COUNT
+// =======================================================
+//
+// N producer threads submit `checkouts` in total over 1M customers,
+// and we time until every one has been processed.
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+template <typename Submit>
+void produce(std::size_t producers, std::size_t checkouts, Submit submit) {
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      std::uint64_t x = p * 0x9E3779B97F4A7C15ULL + 1;
+      for (std::size_t i = p; i < checkouts; i += producers) {
+        x ^= x << 13; // xorshift: cheap customer ids
+        x ^= x >> 7;
+        x ^= x << 17;
+        submit(CustomerId(x % 1000000), 10.0);
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+void benchmark(std::size_t checkouts, std::size_t maxShards) {
+  std::cout << "threads   mutex service   sharded service\n";
+  for (std::size_t n = 1; n <= maxShards; n *= 2) {
+    LockedCheckoutService locked;
+    auto start = Clock::now();
+    produce(n, checkouts, [&](CustomerId c, double a) {
+      locked.processCheckout(c, a);
+    });
+    double lockedMs = millisSince(start);
+
+    double shardedMs;
+    {
+      ShardedCheckoutService sharded(n);
+      start = Clock::now();
+      produce(n, checkouts, [&](CustomerId c, double a) {
+        sharded.processCheckout(c, a);
+      });
+      while (sharded.processed() < checkouts) {
+        std::this_thread::yield();
+      }
+      shardedMs = millisSince(start);
+    }
+    std::cout << n << "\t  " << double(checkouts) / lockedMs / 1000.0
+              << " M/s\t  " << double(checkouts) / shardedMs / 1000.0
+              << " M/s\n";
+  }
+}
+
+//
+// =======================================================
+// 6. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Shared-Nothing Sharded Checkout Demo ===\n\n";
+
+  {
+    ShardedCheckoutService service(4);
+    for (CustomerId c : {17u, 42u, 17u, 99u, 42u, 17u}) {
+      std::cout << "customer " << c << " -> shard " << service.shardFor(c)
+                << "\n";
+      service.processCheckout(c, 25.0);
+    }
+    while (service.processed() < 6) {
+      std::this_thread::yield();
+    }
+    std::cout << "customer 17 spent $" << service.spentBy(17)
+              << " (all on one shard, no lock)\n";
+  }
+
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  std::size_t checkouts = argc > 1 ? std::stoul(argv[1]) : 2000000;
+  std::size_t maxShards = argc > 2 ? std::stoul(argv[2]) : 2 * cores;
+  std::cout << "\n=== Benchmark (" << checkouts << " checkouts, " << cores
+            << " cores) ===\n";
+  benchmark(checkouts, maxShards);
+
+  return 0;
+}
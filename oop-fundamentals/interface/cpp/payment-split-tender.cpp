@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Companion to interface.cpp — pay with Stripe AND PayPal at once.
+//
+// Build: g++ -std=c++17 -O2 -pthread payment-split-tender.cpp -o split
+// Run:   ./split [checkouts]   (default 400 per configuration)
+
+//
+// =======================================================
+// 1. SPLIT TENDER: SUM vs MAX
+// =======================================================
+//
+// A customer pays $100 as $60 on a card (Stripe) + $40 from a wallet
+// (PayPal). Charging the legs one after another:
+//
+//   Stripe  |==== 40 ms ====|
+//   PayPal                  |====== 60 ms ======|      total = SUM
+//
+// The legs are independent, so send them together:
+//
+//   Stripe  |==== 40 ms ====|
+//   PayPal  |====== 60 ms ======|                      total = MAX
+//
+// The catch is atomicity: if PayPal declines after Stripe charged,
+// the customer must not be left half-charged. Each completed leg is
+// COMPENSATED (refunded) — a saga, not a distributed transaction.
+// With fan-out every leg may already have completed by the time the
+// failure is known, so compensation is the normal failure path.
+
+//
+// =======================================================
+// 2. GATEWAY INTERFACE WITH A COMPENSATING ACTION
+// =======================================================
+//
+
+using TransactionId = std::uint64_t;
+
+struct PaymentResult {
+  bool approved;
+  TransactionId transaction;
+};
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual PaymentResult initiatePayment(double amount) = 0;
+  virtual bool refundPayment(TransactionId transaction, double amount) = 0;
+  virtual std::string getProviderName() const = 0;
+};
+
+// Lognormal latency around `medianMs`, declines with `declineRate`.
+// Keeps a ledger of net charged cents to check the saga's invariant.
+class StandInGateway : public PaymentGateway {
+private:
+  std::string name_;
+  double medianMs_, declineRate_;
+  std::atomic<std::int64_t> netCents_{0};
+  std::atomic<std::uint64_t> nextTransaction_{1}, refunds_{0};
+
+  void wait(double ms) {
+    thread_local std::mt19937 rng(std::random_device{}());
+    std::lognormal_distribution<double> jitter(0.0, 0.25);
+    std::this_thread::sleep_for(std::chrono::microseconds(
+        long(ms * jitter(rng) * 1000.0)));
+  }
+
+public:
+  StandInGateway(const std::string &name, double medianMs,
+                 double declineRate)
+      : name_(name), medianMs_(medianMs), declineRate_(declineRate) {}
+
+  PaymentResult initiatePayment(double amount) override {
+    thread_local std::mt19937 rng(std::random_device{}());
+    wait(medianMs_);
+    if (std::uniform_real_distribution<double>(0, 1)(rng) < declineRate_) {
+      return {false, 0};
+    }
+    netCents_ += std::llround(amount * 100);
+    return {true, nextTransaction_++};
+  }
+
+  bool refundPayment(TransactionId, double amount) override {
+    wait(medianMs_ / 2); // refunds are cheaper, but not free
+    netCents_ -= std::llround(amount * 100);
+    ++refunds_;
+    return true;
+  }
+
+  std::string getProviderName() const override { return name_; }
+  std::int64_t netCents() const { return netCents_; }
+  std::uint64_t refunds() const { return refunds_; }
+};
+
+//
+// =======================================================
+// 3. SPLIT-TENDER CHECKOUT: SEQUENTIAL vs FAN-OUT
+// =======================================================
+//
+
+struct Tender {
+  PaymentGateway *gateway;
+  double amount;
+};
+
+struct SplitResult {
+  bool approved;
+  int compensated; // legs refunded because another leg failed
+};
+
+class SplitTenderCheckout {
+private:
+  bool parallel_;
+
+  // Refund every approved leg (in parallel: each refund is a call too)
+  static int compensate(const std::vector<Tender> &tenders,
+                        const std::vector<PaymentResult> &results) {
+    std::vector<std::future<bool>> refunds;
+    for (std::size_t i = 0; i < tenders.size(); ++i) {
+      if (results[i].approved) {
+        refunds.push_back(std::async(std::launch::async, [&, i] {
+          return tenders[i].gateway->refundPayment(results[i].transaction,
+                                                   tenders[i].amount);
+        }));
+      }
+    }
+    int refunded = 0;
+    for (auto &r : refunds) {
+      if (r.get()) {
+        ++refunded;
+      } else {
+        std::cout << "⚠️  Refund failed: needs manual reconciliation\n";
+      }
+    }
+    return refunded;
+  }
+
+public:
+  explicit SplitTenderCheckout(bool parallel) : parallel_(parallel) {}
+
+  SplitResult processCheckout(const std::vector<Tender> &tenders) {
+    std::vector<PaymentResult> results(tenders.size(), {false, 0});
+    bool allApproved = true;
+
+    if (parallel_) {
+      std::vector<std::future<PaymentResult>> legs;
+      for (const Tender &t : tenders) {
+        legs.push_back(std::async(std::launch::async, [t] {
+          return t.gateway->initiatePayment(t.amount);
+        }));
+      }
+      // Every leg must finish before we know what to compensate
+      for (std::size_t i = 0; i < legs.size(); ++i) {
+        results[i] = legs[i].get();
+        allApproved = allApproved && results[i].approved;
+      }
+    } else {
+      for (std::size_t i = 0; i < tenders.size() && allApproved; ++i) {
+        results[i] = tenders[i].gateway->initiatePayment(tenders[i].amount);
+        allApproved = results[i].approved; // stop at the first decline
+      }
+    }
+
+    if (allApproved) {
+      return {true, 0};
+    }
+    return {false, compensate(tenders, results)};
+  }
+};
+
+//
+// =======================================================
+// 4. BENCHMARK
+// =======================================================
+//
+// Stripe ~4 ms, PayPal ~6 ms, Razorpay ~5 ms (median), each declining
+// 3% of payments. Two-leg and three-leg checkouts, one at a time.
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+void run(const char *label, bool parallel, std::size_t legs,
+         std::size_t checkouts) {
+  StandInGateway stripe("Stripe", 4, 0.03), paypal("PayPal", 6, 0.03),
+      razorpay("Razorpay", 5, 0.03);
+  std::vector<Tender> tenders = {{&stripe, 60.0}, {&paypal, 40.0},
+                                 {&razorpay, 25.0}};
+  tenders.resize(legs);
+  double total = 0;
+  for (const Tender &t : tenders) {
+    total += t.amount;
+  }
+
+  SplitTenderCheckout checkout(parallel);
+  std::vector<double> latencyMs;
+  std::size_t approved = 0;
+  int compensated = 0;
+  for (std::size_t i = 0; i < checkouts; ++i) {
+    auto start = Clock::now();
+    SplitResult r = checkout.processCheckout(tenders);
+    latencyMs.push_back(millisSince(start));
+    approved += r.approved;
+    compensated += r.compensated;
+  }
+
+  // The saga's invariant: only fully approved checkouts stay charged
+  std::int64_t charged =
+      stripe.netCents() + paypal.netCents() + razorpay.netCents();
+  bool balanced = charged == std::llround(double(approved) * total * 100);
+
+  std::sort(latencyMs.begin(), latencyMs.end());
+  std::printf("%-22s p50 %5.1f ms  p99 %5.1f ms  declined %3zu  "
+              "refunds %3d  %s\n",
+              label, latencyMs[latencyMs.size() / 2],
+              latencyMs[std::min(latencyMs.size() - 1,
+                                 std::size_t(0.99 * double(checkouts)))],
+              checkouts - approved, compensated,
+              balanced ? "✅ balanced" : "⚠️  PARTIAL CHARGES");
+}
+
+//
+// =======================================================
+// 5. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Split-Tender Fan-Out Demo ===\n\n";
+  {
+    StandInGateway stripe("Stripe", 40, 0.0);
+    StandInGateway paypal("PayPal", 60, 1.0); // always declines
+    SplitTenderCheckout checkout(true);
+    auto start = Clock::now();
+    SplitResult r = checkout.processCheckout({{&stripe, 60}, {&paypal, 40}});
+    std::cout << "💳 $60 Stripe + $40 PayPal: "
+              << (r.approved ? "✅ approved" : "⚠️  declined") << " in "
+              << int(millisSince(start)) << " ms; refunded " << r.compensated
+              << " leg(s), Stripe net $" << stripe.netCents() / 100 << "\n";
+  }
+
+  std::size_t checkouts = argc > 1 ? std::stoul(argv[1]) : 400;
+  std::cout << "\n=== Benchmark (" << checkouts << " checkouts each) ===\n";
+  run("2 legs, sequential", false, 2, checkouts);
+  run("2 legs, fan-out", true, 2, checkouts);
+  run("3 legs, sequential", false, 3, checkouts);
+  run("3 legs, fan-out", true, 3, checkouts);
+
+  return 0;
+}
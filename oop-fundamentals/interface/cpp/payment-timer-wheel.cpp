@@ -0,0 +1,459 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+// Companion to interface.cpp — timeouts and retries for millions of
+// pending payments.
+//
+// Build: g++ -std=c++17 -O2 payment-timer-wheel.cpp -o timer-wheel
+// Run:   ./timer-wheel [schedulesPerTick]   (default 500, 10,000 ticks)
+
+//
+// =======================================================
+// 1. HEAP vs TIMING WHEEL
+// =======================================================
+//
+// Every in-flight payment has a timeout, and failed ones a retry
+// after some backoff. Most timeouts are CANCELLED (the reply arrives
+// first), so cancel() is as hot as schedule().
+//
+//   std::priority_queue      schedule O(log n), no cancel at all:
+//                            entries are only flagged dead and still
+//                            sifted and popped later (lazy deletion)
+//
+//   HIERARCHICAL WHEEL       like a clock face per time scale:
+//      level 0: 256 slots x 1 tick            (next 256 ms)
+//      level 1: 256 slots x 256 ticks         (next ~65 s)
+//      level 2: 256 slots x 65,536 ticks      (next ~4.6 h)
+//      level 3: 256 slots x 16,777,216 ticks  (next ~49 days)
+//   schedule = pick level + slot, push onto that slot's list    O(1)
+//   cancel   = unlink from a doubly-linked list                  O(1)
+//   tick     = fire level-0 slot; every 256 ticks the next level's
+//              slot is CASCADED down into finer slots
+
+//
+// =======================================================
+// 2. THE WHEEL
+// =======================================================
+//
+
+// What to do when a timer fires: plain data, no allocation per timer
+enum class TimerKind : std::uint32_t { Timeout, Retry };
+
+struct TimerEvent {
+  std::uint64_t paymentId;
+  TimerKind kind;
+};
+
+// Handle returned by schedule(). The generation makes a stale handle
+// (timer already fired or cancelled, node reused) harmless.
+struct TimerId {
+  std::uint32_t index;
+  std::uint32_t generation;
+};
+
+class HierarchicalTimerWheel {
+private:
+  static constexpr int kLevels = 4;
+  static constexpr int kBits = 8;
+  static constexpr std::uint32_t kSlots = 1u << kBits;
+  static constexpr std::uint32_t kMask = kSlots - 1;
+  static constexpr std::uint32_t kNil = 0xFFFFFFFFu;
+
+  struct Node {
+    std::uint64_t expires;
+    TimerEvent event;
+    std::uint32_t prev, next; // in a slot list, or next = free list
+    std::uint32_t generation;
+    std::uint16_t level, slot;
+    bool active;
+  };
+
+  std::vector<Node> nodes_;
+  std::uint32_t freeList_ = kNil;
+  std::uint32_t heads_[kLevels][kSlots];
+  std::uint64_t now_ = 0; // current tick
+  std::size_t active_ = 0;
+
+  void link(std::uint32_t i) {
+    Node &n = nodes_[i];
+    std::uint64_t delta = n.expires - now_;
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (std::uint64_t(1)
+                                            << (kBits * (level + 1)))) {
+      ++level;
+    }
+    n.level = std::uint16_t(level);
+    n.slot = std::uint16_t((n.expires >> (kBits * level)) & kMask);
+    std::uint32_t &head = heads_[level][n.slot];
+    n.prev = kNil;
+    n.next = head;
+    if (head != kNil) {
+      nodes_[head].prev = i;
+    }
+    head = i;
+  }
+
+  void unlink(std::uint32_t i) {
+    Node &n = nodes_[i];
+    if (n.prev != kNil) {
+      nodes_[n.prev].next = n.next;
+    } else {
+      heads_[n.level][n.slot] = n.next;
+    }
+    if (n.next != kNil) {
+      nodes_[n.next].prev = n.prev;
+    }
+  }
+
+  void release(std::uint32_t i) {
+    Node &n = nodes_[i];
+    n.active = false;
+    ++n.generation;
+    n.next = freeList_;
+    freeList_ = i;
+    --active_;
+  }
+
+  // Move every timer in a coarse slot down to finer levels
+  void cascade(int level) {
+    std::uint32_t slot = std::uint32_t((now_ >> (kBits * level)) & kMask);
+    std::uint32_t i = heads_[level][slot];
+    heads_[level][slot] = kNil;
+    while (i != kNil) {
+      std::uint32_t next = nodes_[i].next;
+      link(i);
+      i = next;
+    }
+  }
+
+public:
+  HierarchicalTimerWheel() {
+    for (auto &level : heads_) {
+      for (auto &head : level) {
+        head = kNil;
+      }
+    }
+  }
+
+  TimerId schedule(std::uint64_t delayTicks, TimerEvent event) {
+    std::uint32_t i;
+    if (freeList_ != kNil) {
+      i = freeList_;
+      freeList_ = nodes_[i].next;
+    } else {
+      i = std::uint32_t(nodes_.size());
+      nodes_.push_back(Node{});
+    }
+    Node &n = nodes_[i];
+    // A zero delay would land in the slot just processed: fire next tick
+    n.expires = now_ + (delayTicks == 0 ? 1 : delayTicks);
+    n.event = event;
+    n.active = true;
+    link(i);
+    ++active_;
+    return {i, n.generation};
+  }
+
+  // false if the timer already fired or was cancelled
+  bool cancel(TimerId id) {
+    if (id.index >= nodes_.size()) {
+      return false;
+    }
+    Node &n = nodes_[id.index];
+    if (!n.active || n.generation != id.generation) {
+      return false;
+    }
+    unlink(id.index);
+    release(id.index);
+    return true;
+  }
+
+  // Advance to `tick`, calling fire(TimerEvent) for each expired timer.
+  // fire() may schedule or cancel timers.
+  template <typename Fire> void advanceTo(std::uint64_t tick, Fire fire) {
+    while (now_ < tick) {
+      ++now_;
+      for (int level = 1; level < kLevels; ++level) {
+        if ((now_ & ((std::uint64_t(1) << (kBits * level)) - 1)) != 0) {
+          break; // the finer wheel has not wrapped: no cascade
+        }
+        cascade(level);
+      }
+      std::uint32_t &head = heads_[0][now_ & kMask];
+      while (head != kNil) {
+        std::uint32_t i = head;
+        unlink(i);
+        TimerEvent event = nodes_[i].event;
+        release(i);
+        fire(event);
+      }
+    }
+  }
+
+  std::uint64_t now() const { return now_; }
+  std::size_t pending() const { return active_; }
+  std::size_t memoryBytes() const {
+    return nodes_.capacity() * sizeof(Node) + sizeof(heads_);
+  }
+};
+
+//
+// =======================================================
+// 3. BASELINE: BINARY HEAP WITH LAZY CANCELLATION
+// =======================================================
+//
+
+class HeapTimerQueue {
+private:
+  struct Entry {
+    std::uint64_t expires;
+    std::uint32_t index, generation;
+    bool operator>(const Entry &o) const { return expires > o.expires; }
+  };
+  struct Slot {
+    TimerEvent event;
+    std::uint32_t generation = 0;
+    bool active = false;
+  };
+
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap_;
+  std::vector<Slot> slots_;
+  std::vector<std::uint32_t> free_;
+  std::uint64_t now_ = 0;
+  std::size_t active_ = 0;
+
+  void release(std::uint32_t i) {
+    slots_[i].active = false;
+    ++slots_[i].generation;
+    free_.push_back(i);
+    --active_;
+  }
+
+public:
+  TimerId schedule(std::uint64_t delayTicks, TimerEvent event) {
+    std::uint32_t i;
+    if (!free_.empty()) {
+      i = free_.back();
+      free_.pop_back();
+    } else {
+      i = std::uint32_t(slots_.size());
+      slots_.emplace_back();
+    }
+    slots_[i].event = event;
+    slots_[i].active = true;
+    heap_.push({now_ + (delayTicks == 0 ? 1 : delayTicks), i,
+                slots_[i].generation});
+    ++active_;
+    return {i, slots_[i].generation};
+  }
+
+  bool cancel(TimerId id) {
+    if (id.index >= slots_.size() || !slots_[id.index].active ||
+        slots_[id.index].generation != id.generation) {
+      return false;
+    }
+    release(id.index); // the heap entry stays behind until popped
+    return true;
+  }
+
+  template <typename Fire> void advanceTo(std::uint64_t tick, Fire fire) {
+    now_ = tick;
+    while (!heap_.empty() && heap_.top().expires <= now_) {
+      Entry e = heap_.top();
+      heap_.pop();
+      Slot &s = slots_[e.index];
+      if (s.active && s.generation == e.generation) {
+        TimerEvent event = s.event;
+        release(e.index);
+        fire(event);
+      }
+    }
+  }
+
+  std::size_t pending() const { return active_; }
+  std::size_t memoryBytes() const {
+    return heap_.size() * sizeof(Entry) + slots_.capacity() * sizeof(Slot);
+  }
+};
+
+//
+// =======================================================
+// 4. RETRIES AND TIMEOUTS FOR initiatePayment()
+// =======================================================
+//
+// Each checkout gets a DEADLINE timer. A declined attempt schedules a
+// RETRY with exponential backoff. Success cancels the deadline; the
+// deadline firing abandons the payment.
+
+class PaymentGateway {
+public:
+  virtual ~PaymentGateway() {}
+  virtual bool initiatePayment(double amount) = 0; // true = approved
+  virtual std::string getProviderName() const = 0;
+};
+
+// Declines the first `failures` attempts of every payment
+class FlakyGateway : public PaymentGateway {
+private:
+  int failures_;
+  int attempts_ = 0;
+
+public:
+  explicit FlakyGateway(int failures) : failures_(failures) {}
+
+  bool initiatePayment(double amount) override {
+    bool ok = ++attempts_ > failures_;
+    std::cout << "  💳 " << (ok ? "approved" : "declined") << " $" << amount
+              << "\n";
+    if (ok) {
+      attempts_ = 0;
+    }
+    return ok;
+  }
+
+  std::string getProviderName() const override { return "Flaky"; }
+};
+
+class RetryingCheckout {
+private:
+  struct Pending {
+    double amount;
+    int attempt;
+    TimerId deadline;
+    bool open;
+  };
+
+  PaymentGateway &gateway_;
+  HierarchicalTimerWheel &wheel_;
+  std::vector<Pending> payments_;
+  std::uint64_t baseBackoff_, deadline_;
+
+  void attempt(std::uint64_t id) {
+    Pending &p = payments_[id];
+    if (gateway_.initiatePayment(p.amount)) {
+      wheel_.cancel(p.deadline);
+      p.open = false;
+      std::cout << "✅ payment " << id << " done at t=" << wheel_.now()
+                << " ms\n";
+      return;
+    }
+    std::uint64_t backoff = baseBackoff_ << p.attempt++; // 100, 200, 400...
+    wheel_.schedule(backoff, {id, TimerKind::Retry});
+  }
+
+public:
+  RetryingCheckout(PaymentGateway &gateway, HierarchicalTimerWheel &wheel,
+                   std::uint64_t baseBackoffMs, std::uint64_t deadlineMs)
+      : gateway_(gateway), wheel_(wheel), baseBackoff_(baseBackoffMs),
+        deadline_(deadlineMs) {}
+
+  std::uint64_t processCheckout(double amount) {
+    std::uint64_t id = payments_.size();
+    payments_.push_back({amount, 0, {}, true});
+    payments_[id].deadline =
+        wheel_.schedule(deadline_, {id, TimerKind::Timeout});
+    attempt(id);
+    return id;
+  }
+
+  void onTimer(TimerEvent e) {
+    Pending &p = payments_[e.paymentId];
+    if (!p.open) {
+      return; // a retry that outlived its payment
+    }
+    if (e.kind == TimerKind::Retry) {
+      attempt(e.paymentId);
+    } else {
+      p.open = false;
+      std::cout << "⏰ payment " << e.paymentId << " timed out at t="
+                << wheel_.now() << " ms\n";
+    }
+  }
+};
+
+//
+// =======================================================
+// 5. BENCHMARK: MILLIONS OF PENDING TIMEOUTS
+// =======================================================
+//
+// Per 1 ms tick: schedule N timeouts (1–30 s), cancel 90% as many
+// random pending ones (replies arriving), fire whatever expires.
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+template <typename Timers>
+void run(const char *label, std::size_t perTick, std::uint64_t ticks) {
+  Timers timers;
+  std::mt19937_64 rng(71);
+  std::uniform_int_distribution<std::uint64_t> timeout(1000, 30000);
+  std::vector<TimerId> live; // cancel candidates (may be stale)
+  std::size_t cancels = perTick * 9 / 10, fired = 0, peak = 0;
+  std::uint64_t ops = 0;
+
+  auto start = Clock::now();
+  for (std::uint64_t t = 1; t <= ticks; ++t) {
+    for (std::size_t i = 0; i < perTick; ++i) {
+      live.push_back(timers.schedule(timeout(rng), {i, TimerKind::Timeout}));
+    }
+    for (std::size_t i = 0; i < cancels && !live.empty(); ++i) {
+      std::size_t k = std::size_t(rng() % live.size());
+      timers.cancel(live[k]);
+      live[k] = live.back(); // swap-and-pop
+      live.pop_back();
+    }
+    timers.advanceTo(t, [&](TimerEvent) { ++fired; });
+    ops += perTick + cancels;
+    peak = std::max(peak, timers.pending());
+  }
+  double ms = millisSince(start);
+  std::cout << label << ms * 1e6 / double(ops) << " ns/op, peak "
+            << peak << " pending, " << fired << " fired, "
+            << timers.memoryBytes() / (1024 * 1024) << " MB\n";
+}
+
+//
+// =======================================================
+// 6. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Hierarchical Timing Wheel Demo ===\n\n";
+
+  {
+    HierarchicalTimerWheel wheel;
+    FlakyGateway gateway(2); // two declines, then approval
+    RetryingCheckout checkout(gateway, wheel, 100, 1000);
+    checkout.processCheckout(49.99);
+    wheel.advanceTo(2000, [&](TimerEvent e) { checkout.onTimer(e); });
+
+    std::cout << "\nA gateway that keeps declining:\n";
+    FlakyGateway broken(100);
+    RetryingCheckout doomed(broken, wheel, 100, 1000);
+    doomed.processCheckout(15.00);
+    wheel.advanceTo(4000, [&](TimerEvent e) { doomed.onTimer(e); });
+  }
+
+  std::size_t perTick = argc > 1 ? std::stoul(argv[1]) : 500;
+  const std::uint64_t ticks = 10000;
+  std::cout << "\n=== Benchmark (" << perTick << " schedules + "
+            << perTick * 9 / 10 << " cancels per tick, " << ticks
+            << " ticks) ===\n";
+  run<HierarchicalTimerWheel>("Timing wheel:   ", perTick, ticks);
+  run<HeapTimerQueue>("priority_queue: ", perTick, ticks);
+
+  return 0;
+}
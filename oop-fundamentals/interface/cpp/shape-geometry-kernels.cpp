@@ -0,0 +1,387 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#if defined(__SSE__)
+#include <immintrin.h>
+#endif
+
+// Companion to interface.cpp — geometry for millions of shapes per frame.
+//
+// Build: g++ -std=c++17 -O2 shape-geometry-kernels.cpp -o geometry-kernels
+//        (add -mavx2 or -march=native for the 8-wide path)
+// Run:   ./geometry-kernels [shapeCount]   (default 4,000,000)
+
+//
+// =======================================================
+// 1. WHY BATCH KERNELS?
+// =======================================================
+//
+// The OOP way asks each object:
+//
+//     for (Shape *s : shapes) total += s->area();   // virtual call each
+//
+// Every call is an indirect jump, and each object sits somewhere else
+// on the heap. The CPU cannot vectorise across objects it reaches one
+// pointer at a time.
+//
+// DATA-ORIENTED alternative: STRUCTURE OF ARRAYS (SoA)
+//   CircleBatch    { cx[], cy[], r[] }
+//   RectangleBatch { x[], y[], w[], h[] }
+// A kernel then processes 4 (SSE) or 8 (AVX) shapes per instruction
+// over contiguous memory, with no virtual calls at all.
+
+//
+// =======================================================
+// 2. SIMD WRAPPER (one kernel body, three widths)
+// =======================================================
+//
+
+#if defined(__AVX__)
+struct Vec {
+  static constexpr std::size_t width = 8;
+  __m256 v;
+
+  static Vec load(const float *p) { return {_mm256_loadu_ps(p)}; }
+  static Vec splat(float f) { return {_mm256_set1_ps(f)}; }
+  void store(float *p) const { _mm256_storeu_ps(p, v); }
+};
+inline Vec operator+(Vec a, Vec b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm256_mul_ps(a.v, b.v)}; }
+#elif defined(__SSE__)
+struct Vec {
+  static constexpr std::size_t width = 4;
+  __m128 v;
+
+  static Vec load(const float *p) { return {_mm_loadu_ps(p)}; }
+  static Vec splat(float f) { return {_mm_set1_ps(f)}; }
+  void store(float *p) const { _mm_storeu_ps(p, v); }
+};
+inline Vec operator+(Vec a, Vec b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm_mul_ps(a.v, b.v)}; }
+#else
+struct Vec {
+  static constexpr std::size_t width = 1;
+  float v;
+
+  static Vec load(const float *p) { return {*p}; }
+  static Vec splat(float f) { return {f}; }
+  void store(float *p) const { *p = v; }
+};
+inline Vec operator+(Vec a, Vec b) { return {a.v + b.v}; }
+inline Vec operator-(Vec a, Vec b) { return {a.v - b.v}; }
+inline Vec operator*(Vec a, Vec b) { return {a.v * b.v}; }
+#endif
+
+constexpr float kPi = 3.14159265358979f;
+
+//
+// =======================================================
+// 3. CONTIGUOUS STORAGE (SoA)
+// =======================================================
+//
+
+struct CircleBatch {
+  std::vector<float> cx, cy, r;
+
+  void add(float x, float y, float radius) {
+    cx.push_back(x);
+    cy.push_back(y);
+    r.push_back(radius);
+  }
+  std::size_t size() const { return r.size(); }
+};
+
+struct RectangleBatch {
+  std::vector<float> x, y, w, h;
+
+  void add(float px, float py, float pw, float ph) {
+    x.push_back(px);
+    y.push_back(py);
+    w.push_back(pw);
+    h.push_back(ph);
+  }
+  std::size_t size() const { return w.size(); }
+};
+
+// Output of the bounds kernels, also SoA
+struct BoundsBatch {
+  std::vector<float> minX, minY, maxX, maxY;
+
+  void resize(std::size_t n) {
+    minX.resize(n);
+    minY.resize(n);
+    maxX.resize(n);
+    maxY.resize(n);
+  }
+};
+
+//
+// =======================================================
+// 4. BATCH KERNELS
+// =======================================================
+//
+// Pattern: SIMD main loop over `width` lanes, scalar tail for the rest.
+// Callers size `out` to batch.size().
+
+void circleArea(const CircleBatch &c, float *out) {
+  const std::size_t n = c.size();
+  const Vec pi = Vec::splat(kPi);
+  std::size_t i = 0;
+  for (; i + Vec::width <= n; i += Vec::width) {
+    Vec r = Vec::load(&c.r[i]);
+    (pi * r * r).store(out + i);
+  }
+  for (; i < n; ++i) {
+    out[i] = kPi * c.r[i] * c.r[i];
+  }
+}
+
+void circlePerimeter(const CircleBatch &c, float *out) {
+  const std::size_t n = c.size();
+  const Vec twoPi = Vec::splat(2 * kPi);
+  std::size_t i = 0;
+  for (; i + Vec::width <= n; i += Vec::width) {
+    (twoPi * Vec::load(&c.r[i])).store(out + i);
+  }
+  for (; i < n; ++i) {
+    out[i] = 2 * kPi * c.r[i];
+  }
+}
+
+void circleBounds(const CircleBatch &c, BoundsBatch &out) {
+  const std::size_t n = c.size();
+  std::size_t i = 0;
+  for (; i + Vec::width <= n; i += Vec::width) {
+    Vec x = Vec::load(&c.cx[i]), y = Vec::load(&c.cy[i]);
+    Vec r = Vec::load(&c.r[i]);
+    (x - r).store(&out.minX[i]);
+    (y - r).store(&out.minY[i]);
+    (x + r).store(&out.maxX[i]);
+    (y + r).store(&out.maxY[i]);
+  }
+  for (; i < n; ++i) {
+    out.minX[i] = c.cx[i] - c.r[i];
+    out.minY[i] = c.cy[i] - c.r[i];
+    out.maxX[i] = c.cx[i] + c.r[i];
+    out.maxY[i] = c.cy[i] + c.r[i];
+  }
+}
+
+void rectangleArea(const RectangleBatch &rc, float *out) {
+  const std::size_t n = rc.size();
+  std::size_t i = 0;
+  for (; i + Vec::width <= n; i += Vec::width) {
+    (Vec::load(&rc.w[i]) * Vec::load(&rc.h[i])).store(out + i);
+  }
+  for (; i < n; ++i) {
+    out[i] = rc.w[i] * rc.h[i];
+  }
+}
+
+void rectanglePerimeter(const RectangleBatch &rc, float *out) {
+  const std::size_t n = rc.size();
+  const Vec two = Vec::splat(2);
+  std::size_t i = 0;
+  for (; i + Vec::width <= n; i += Vec::width) {
+    (two * (Vec::load(&rc.w[i]) + Vec::load(&rc.h[i]))).store(out + i);
+  }
+  for (; i < n; ++i) {
+    out[i] = 2 * (rc.w[i] + rc.h[i]);
+  }
+}
+
+void rectangleBounds(const RectangleBatch &rc, BoundsBatch &out) {
+  const std::size_t n = rc.size();
+  std::size_t i = 0;
+  for (; i + Vec::width <= n; i += Vec::width) {
+    Vec x = Vec::load(&rc.x[i]), y = Vec::load(&rc.y[i]);
+    x.store(&out.minX[i]);
+    y.store(&out.minY[i]);
+    (x + Vec::load(&rc.w[i])).store(&out.maxX[i]);
+    (y + Vec::load(&rc.h[i])).store(&out.maxY[i]);
+  }
+  for (; i < n; ++i) {
+    out.minX[i] = rc.x[i];
+    out.minY[i] = rc.y[i];
+    out.maxX[i] = rc.x[i] + rc.w[i];
+    out.maxY[i] = rc.y[i] + rc.h[i];
+  }
+}
+
+//
+// =======================================================
+// 5. BASELINE: ONE VIRTUAL CALL PER SHAPE
+// =======================================================
+//
+
+struct Bounds {
+  float minX, minY, maxX, maxY;
+};
+
+class Measurable {
+public:
+  virtual ~Measurable() {}
+  virtual float area() const = 0;
+  virtual float perimeter() const = 0;
+  virtual Bounds bounds() const = 0;
+};
+
+class Circle : public Measurable {
+private:
+  float cx_, cy_, r_;
+
+public:
+  Circle(float cx, float cy, float r) : cx_(cx), cy_(cy), r_(r) {}
+  float area() const override { return kPi * r_ * r_; }
+  float perimeter() const override { return 2 * kPi * r_; }
+  Bounds bounds() const override {
+    return {cx_ - r_, cy_ - r_, cx_ + r_, cy_ + r_};
+  }
+};
+
+class Rectangle : public Measurable {
+private:
+  float x_, y_, w_, h_;
+
+public:
+  Rectangle(float x, float y, float w, float h) : x_(x), y_(y), w_(w), h_(h) {}
+  float area() const override { return w_ * h_; }
+  float perimeter() const override { return 2 * (w_ + h_); }
+  Bounds bounds() const override { return {x_, y_, x_ + w_, y_ + h_}; }
+};
+
+//
+// =======================================================
+// 6. BENCHMARK
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+void benchmark(std::size_t count) {
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> pos(0, 10000), len(1, 50);
+  std::uniform_int_distribution<int> coin(0, 1);
+
+  CircleBatch circles;
+  RectangleBatch rects;
+  std::vector<std::unique_ptr<Measurable>> objects;
+  objects.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    float x = pos(rng), y = pos(rng), a = len(rng), b = len(rng);
+    if (coin(rng) != 0) {
+      circles.add(x, y, a);
+      objects.push_back(std::make_unique<Circle>(x, y, a));
+    } else {
+      rects.add(x, y, a, b);
+      objects.push_back(std::make_unique<Rectangle>(x, y, a, b));
+    }
+  }
+
+  // Virtual-call baseline: area + perimeter + bounds per object
+  std::vector<float> area(count), perim(count);
+  BoundsBatch box;
+  box.resize(count);
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < count; ++i) {
+    const Measurable &m = *objects[i];
+    area[i] = m.area();
+    perim[i] = m.perimeter();
+    Bounds b = m.bounds();
+    box.minX[i] = b.minX;
+    box.minY[i] = b.minY;
+    box.maxX[i] = b.maxX;
+    box.maxY[i] = b.maxY;
+  }
+  double virtualMs = millisSince(start);
+  double virtualSum = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    virtualSum += double(area[i]) + perim[i] + box.maxX[i];
+  }
+
+  // Batch kernels over SoA storage
+  std::vector<float> cArea(circles.size()), cPerim(circles.size());
+  std::vector<float> rArea(rects.size()), rPerim(rects.size());
+  BoundsBatch cBox, rBox;
+  cBox.resize(circles.size());
+  rBox.resize(rects.size());
+  start = Clock::now();
+  circleArea(circles, cArea.data());
+  circlePerimeter(circles, cPerim.data());
+  circleBounds(circles, cBox);
+  rectangleArea(rects, rArea.data());
+  rectanglePerimeter(rects, rPerim.data());
+  rectangleBounds(rects, rBox);
+  double batchMs = millisSince(start);
+  double batchSum = 0;
+  for (std::size_t i = 0; i < circles.size(); ++i) {
+    batchSum += double(cArea[i]) + cPerim[i] + cBox.maxX[i];
+  }
+  for (std::size_t i = 0; i < rects.size(); ++i) {
+    batchSum += double(rArea[i]) + rPerim[i] + rBox.maxX[i];
+  }
+
+  std::cout << "SIMD width: " << Vec::width << " floats\n";
+  std::cout << "Virtual per shape: " << virtualMs << " ms ("
+            << double(count) / virtualMs / 1e3 << " M shapes/s)\n";
+  std::cout << "Batch kernels:     " << batchMs << " ms ("
+            << double(count) / batchMs / 1e3 << " M shapes/s)\n";
+  std::cout << "Speed-up: " << virtualMs / batchMs << "x, results "
+            << (std::fabs(virtualSum - batchSum) < 1e-6 * virtualSum
+                    ? "match"
+                    : "DIFFER")
+            << "\n";
+}
+
+//
+// =======================================================
+// 7. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Geometry Kernels Demo ===\n\n";
+
+  CircleBatch circles;
+  circles.add(0, 0, 1);
+  circles.add(10, 10, 2);
+  RectangleBatch rects;
+  rects.add(0, 0, 3, 4);
+
+  std::vector<float> area(circles.size()), perim(circles.size());
+  BoundsBatch box;
+  box.resize(circles.size());
+  circleArea(circles, area.data());
+  circlePerimeter(circles, perim.data());
+  circleBounds(circles, box);
+  for (std::size_t i = 0; i < circles.size(); ++i) {
+    std::cout << "Circle r=" << circles.r[i] << ": area=" << area[i]
+              << " perimeter=" << perim[i] << " bounds=[" << box.minX[i]
+              << "," << box.minY[i] << " -> " << box.maxX[i] << ","
+              << box.maxY[i] << "]\n";
+  }
+
+  float rArea = 0, rPerim = 0;
+  rectangleArea(rects, &rArea);
+  rectanglePerimeter(rects, &rPerim);
+  std::cout << "Rectangle 3x4: area=" << rArea << " perimeter=" << rPerim
+            << "\n";
+
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 4000000;
+  std::cout << "\n=== Benchmark (" << count << " shapes) ===\n";
+  benchmark(count);
+
+  return 0;
+}
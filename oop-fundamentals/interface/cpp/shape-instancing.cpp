@@ -0,0 +1,436 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Companion to interface.cpp — draw a thousand identical shapes once.
+//
+// Build: g++ -std=c++17 -O2 shape-instancing.cpp -o shape-instancing
+// Run:   ./shape-instancing [shapeCount] [distinctKinds]
+//        (default 1,000,000 shapes of 50 kinds)
+
+//
+// =======================================================
+// 1. WHY INSTANCING?
+// =======================================================
+//
+// A forest is 100,000 trees but only 5 kinds of tree. Drawing each
+// one re-sends its name, size and draw setup every frame.
+//
+// INSTANCING splits a shape into:
+//   - INVARIANT state (name + size)   -> sent once per group
+//   - PER-INSTANCE state (position)   -> a packed array of transforms
+//
+// One drawInstanced() call then covers the whole group. The renderer
+// reads one contiguous transform array instead of chasing N objects.
+
+//
+// =======================================================
+// 2. INTERFACES
+// =======================================================
+//
+
+struct Transform {
+  std::int32_t x, y; // 8 bytes per instance
+};
+
+class Drawable {
+public:
+  virtual ~Drawable() {}
+  virtual void draw() const = 0;
+};
+
+class Movable {
+public:
+  virtual ~Movable() {}
+  virtual void move(int x, int y) = 0;
+};
+
+class Resizable {
+public:
+  virtual ~Resizable() {}
+  virtual void resize(double factor) = 0;
+};
+
+// Output target supporting both the classic and the instanced path
+class Canvas {
+public:
+  virtual ~Canvas() {}
+  virtual void drawShape(const std::string &name, double size, int x,
+                         int y) = 0;
+  virtual void drawInstanced(const std::string &name, double size,
+                             const Transform *instances,
+                             std::size_t count) = 0;
+};
+
+class Shape;
+
+class ShapeObserver {
+public:
+  virtual ~ShapeObserver() {}
+  virtual void onShapeChanged(Shape &shape) = 0;
+};
+
+//
+// =======================================================
+// 3. SHAPE
+// =======================================================
+//
+
+class Shape : public Drawable, public Movable, public Resizable {
+private:
+  std::string name_;
+  int x_ = 0, y_ = 0;
+  double size_ = 1.0;
+  ShapeObserver *observer_ = nullptr;
+
+  // Bookkeeping owned by the batcher (which group / slot we live in)
+  friend class InstanceBatcher;
+  std::int32_t group_ = -1;
+  std::int32_t slot_ = -1;
+
+public:
+  Shape(const std::string &name, int x, int y, double size)
+      : name_(name), x_(x), y_(y), size_(size) {}
+
+  // A copy is a new shape: same geometry, but in no batch and watched
+  // by no one. Copying the slot would let two shapes fight over it.
+  Shape(const Shape &o)
+      : name_(o.name_), x_(o.x_), y_(o.y_), size_(o.size_) {}
+  Shape &operator=(const Shape &) = delete;
+
+  void setObserver(ShapeObserver *observer) { observer_ = observer; }
+
+  const std::string &name() const { return name_; }
+  double size() const { return size_; }
+  Transform transform() const { return {x_, y_}; }
+
+  void draw() const override {
+    std::cout << "Drawing " << name_ << " at (" << x_ << "," << y_ << ")"
+              << " size=" << size_ << "\n";
+  }
+
+  void move(int x, int y) override {
+    x_ = x;
+    y_ = y;
+    if (observer_ != nullptr) {
+      observer_->onShapeChanged(*this);
+    }
+  }
+
+  void resize(double factor) override {
+    size_ *= factor;
+    if (observer_ != nullptr) {
+      observer_->onShapeChanged(*this);
+    }
+  }
+};
+
+//
+// =======================================================
+// 4. INSTANCE BATCHER
+// =======================================================
+//
+// Groups are keyed by the invariant properties. move() only rewrites
+// one Transform in place; resize() changes the key, so the shape moves
+// to another group (swap-and-pop out, push_back in). A group left
+// empty is swap-and-popped out of groups_ too, so a shape animated with
+// resize() does not leave one dead group per size it passed through.
+
+class InstanceBatcher : public ShapeObserver {
+private:
+  struct Key {
+    std::string name;
+    double size;
+
+    bool operator==(const Key &o) const {
+      return size == o.size && name == o.name;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key &k) const {
+      return std::hash<std::string>()(k.name) ^
+             (std::hash<double>()(k.size) * 31);
+    }
+  };
+
+  struct Group {
+    Key key;
+    std::vector<Transform> instances;
+    std::vector<Shape *> owners; // owners[i] is drawn by instances[i]
+  };
+
+  std::vector<Group> groups_;
+  std::unordered_map<Key, std::int32_t, KeyHash> lookup_;
+
+  std::int32_t groupFor(const Shape &shape) {
+    Key key{shape.name(), shape.size()};
+    auto it = lookup_.find(key);
+    if (it != lookup_.end()) {
+      return it->second;
+    }
+    auto index = std::int32_t(groups_.size());
+    groups_.push_back({key, {}, {}});
+    lookup_.emplace(std::move(key), index);
+    return index;
+  }
+
+  void attach(Shape &shape, std::int32_t group) {
+    Group &g = groups_[group];
+    shape.group_ = group;
+    shape.slot_ = std::int32_t(g.instances.size());
+    g.instances.push_back(shape.transform());
+    g.owners.push_back(&shape);
+  }
+
+  void detach(Shape &shape) {
+    Group &g = groups_[shape.group_];
+    Shape *last = g.owners.back();
+    g.instances[shape.slot_] = g.instances.back();
+    g.owners[shape.slot_] = last;
+    last->slot_ = shape.slot_;
+    g.instances.pop_back();
+    g.owners.pop_back();
+    if (g.instances.empty()) {
+      eraseGroup(shape.group_);
+    }
+    shape.group_ = shape.slot_ = -1;
+  }
+
+  // The last group takes the hole; its owners learn their new index
+  // (O(members of that group), paid only when a group dies)
+  void eraseGroup(std::int32_t index) {
+    lookup_.erase(groups_[index].key);
+    auto last = std::int32_t(groups_.size() - 1);
+    if (index != last) {
+      groups_[index] = std::move(groups_[last]);
+      for (Shape *owner : groups_[index].owners) {
+        owner->group_ = index;
+      }
+      lookup_[groups_[index].key] = index;
+    }
+    groups_.pop_back();
+  }
+
+public:
+  void add(Shape &shape) {
+    attach(shape, groupFor(shape));
+    shape.setObserver(this);
+  }
+
+  void onShapeChanged(Shape &shape) override {
+    // Fast path: key unchanged (a plain move) — no hashing needed
+    Group &current = groups_[shape.group_];
+    if (current.key.size == shape.size() &&
+        current.key.name == shape.name()) {
+      current.instances[shape.slot_] = shape.transform();
+      return;
+    }
+    detach(shape);
+    attach(shape, groupFor(shape));
+  }
+
+  std::size_t groupCount() const { return groups_.size(); }
+
+  void render(Canvas &canvas) const {
+    for (const auto &g : groups_) {
+      if (!g.instances.empty()) {
+        canvas.drawInstanced(g.key.name, g.key.size, g.instances.data(),
+                             g.instances.size());
+      }
+    }
+  }
+};
+
+// Baseline: one draw per shape, like renderShapes() in interface.cpp
+void renderEach(const std::vector<Shape> &shapes, Canvas &canvas) {
+  for (const auto &s : shapes) {
+    Transform t = s.transform();
+    canvas.drawShape(s.name(), s.size(), t.x, t.y);
+  }
+}
+
+//
+// =======================================================
+// 5. CANVAS IMPLEMENTATIONS
+// =======================================================
+//
+
+class ConsoleCanvas : public Canvas {
+public:
+  void drawShape(const std::string &name, double size, int x,
+                 int y) override {
+    std::cout << "  draw " << name << " size=" << size << " at (" << x << ","
+              << y << ")\n";
+  }
+
+  void drawInstanced(const std::string &name, double size,
+                     const Transform *instances, std::size_t count) override {
+    std::cout << "  drawInstanced " << name << " size=" << size << " x"
+              << count << ":";
+    for (std::size_t i = 0; i < count; ++i) {
+      std::cout << " (" << instances[i].x << "," << instances[i].y << ")";
+    }
+    std::cout << "\n";
+  }
+};
+
+// Serialises commands into a byte stream, the way a driver fills a
+// command buffer. Bytes written = memory traffic we are trying to cut.
+class CommandStreamCanvas : public Canvas {
+private:
+  template <typename T> void put(const T &value) {
+    const auto *p = reinterpret_cast<const unsigned char *>(&value);
+    stream.insert(stream.end(), p, p + sizeof(T));
+  }
+
+  void putString(const std::string &s) {
+    put(std::uint32_t(s.size()));
+    stream.insert(stream.end(), s.begin(), s.end());
+  }
+
+public:
+  std::vector<unsigned char> stream;
+  std::size_t calls = 0;
+
+  void drawShape(const std::string &name, double size, int x,
+                 int y) override {
+    ++calls;
+    put(std::uint8_t(1));
+    putString(name);
+    put(size);
+    put(Transform{x, y});
+  }
+
+  void drawInstanced(const std::string &name, double size,
+                     const Transform *instances, std::size_t count) override {
+    ++calls;
+    put(std::uint8_t(2));
+    putString(name);
+    put(size);
+    put(std::uint64_t(count));
+    const auto *p = reinterpret_cast<const unsigned char *>(instances);
+    stream.insert(stream.end(), p, p + count * sizeof(Transform));
+  }
+};
+
+//
+// =======================================================
+// 6. BENCHMARK
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+void benchmark(std::size_t count, int kinds) {
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<int> pos(0, 10000), kind(0, kinds - 1);
+
+  std::vector<Shape> shapes;
+  shapes.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    int k = kind(rng);
+    shapes.emplace_back("Sprite kind #" + std::to_string(k), pos(rng),
+                        pos(rng), 1.0 + k % 8);
+  }
+  InstanceBatcher batcher;
+  for (auto &s : shapes) {
+    batcher.add(s);
+  }
+
+  CommandStreamCanvas each, instanced;
+  each.stream.reserve(count * 48);
+  instanced.stream.reserve(count * 12);
+  const int frames = 10;
+  double eachMs = 0, instMs = 0;
+  for (int f = 0; f < frames; ++f) {
+    each.stream.clear();
+    each.calls = 0;
+    auto start = Clock::now();
+    renderEach(shapes, each);
+    eachMs += millisSince(start);
+
+    instanced.stream.clear();
+    instanced.calls = 0;
+    start = Clock::now();
+    batcher.render(instanced);
+    instMs += millisSince(start);
+  }
+
+  std::cout << "                 draw calls    bytes/frame    ms/frame\n";
+  std::cout << "Per-shape:       " << each.calls << "       "
+            << each.stream.size() << "       " << eachMs / frames << "\n";
+  std::cout << "Instanced:       " << instanced.calls << "            "
+            << instanced.stream.size() << "        " << instMs / frames
+            << "\n";
+  std::cout << "Reduction: " << double(each.calls) / double(instanced.calls)
+            << "x fewer calls, "
+            << double(each.stream.size()) / double(instanced.stream.size())
+            << "x fewer bytes, " << eachMs / instMs << "x faster\n";
+
+  // Moving 10% of shapes only patches their Transform in place
+  std::size_t moved = count / 10;
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < moved; ++i) {
+    shapes[(i * 7919) % count].move(pos(rng), pos(rng));
+  }
+  std::cout << "move() with batcher update: "
+            << millisSince(start) * 1e6 / double(moved) << " ns/shape\n";
+}
+
+//
+// =======================================================
+// 7. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Instanced Drawing Demo ===\n";
+
+  std::vector<Shape> forest = {{"Pine", 10, 10, 3},
+                               {"Pine", 40, 12, 3},
+                               {"Oak", 20, 30, 5},
+                               {"Pine", 70, 8, 3},
+                               {"Oak", 55, 35, 5}};
+  InstanceBatcher batcher;
+  for (auto &tree : forest) {
+    batcher.add(tree);
+  }
+
+  ConsoleCanvas console;
+  std::cout << "\nPer-shape (" << forest.size() << " calls):\n";
+  renderEach(forest, console);
+  std::cout << "\nInstanced (" << batcher.groupCount() << " calls):\n";
+  batcher.render(console);
+
+  forest[1].move(42, 14); // same group, transform patched
+  forest[3].resize(2.0);  // new size -> new group
+  std::cout << "\nAfter move() + resize():\n";
+  batcher.render(console);
+
+  // Grow one tree a little every frame: its old groups are reclaimed
+  for (int frame = 0; frame < 1000; ++frame) {
+    forest[3].resize(1.01);
+  }
+  std::cout << "After 1000 resize() frames: " << batcher.groupCount()
+            << " groups\n";
+
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  int kinds = argc > 2 ? std::stoi(argv[2]) : 50;
+  std::cout << "\n=== Benchmark (" << count << " shapes, " << kinds
+            << " kinds) ===\n";
+  benchmark(count, kinds);
+
+  return 0;
+}
@@ -0,0 +1,428 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Companion to interface.cpp — load a whole scene with one mmap().
+//
+// Build: g++ -std=c++17 -O2 shape-scene-mmap.cpp -o shape-scene-mmap
+// Run:   ./shape-scene-mmap [shapeCount] [path]
+//        (default 10,000,000 shapes in /tmp/shapes.scene; POSIX only)
+
+//
+// =======================================================
+// 1. WHY A MEMORY-MAPPED FORMAT?
+// =======================================================
+//
+// Building a scene through constructors means, per shape:
+//   parse -> allocate a std::string -> construct -> push_back
+// For 10M shapes that is 10M allocations before the first frame.
+//
+// Instead, we lay the file out EXACTLY like the in-memory array:
+//
+//   +--------------+---------------------------+----------------+
+//   | SceneHeader  | ShapeRecord[shapeCount]   | string table   |
+//   +--------------+---------------------------+----------------+
+//
+// Opening = mmap() + validate the header. The records ARE the
+// contiguous shape storage; the OS pages them in on first touch.
+// Names are (offset, length) pairs into one shared string table,
+// so "Circle" is stored once no matter how many circles exist.
+//
+// ⚠️ The file is native-endian (little-endian on x86/ARM) and the
+//    struct layouts are pinned with static_assert below.
+//
+// A scene file is untrusted input. open() checks the header with
+// overflow-free arithmetic (each offset against the file length first,
+// then counts by division) and the records' alignment. Names are
+// checked LAZILY, in ShapeView::name(): checking them all up front
+// would touch every record and make open() O(shapes) again.
+
+//
+// =======================================================
+// 2. SHAPE (constructor-built baseline)
+// =======================================================
+//
+
+enum class ShapeType : std::uint16_t { Generic = 0, Circle = 1, Rectangle = 2 };
+
+const char *toString(ShapeType type) {
+  switch (type) {
+  case ShapeType::Circle:    return "Circle";
+  case ShapeType::Rectangle: return "Rectangle";
+  case ShapeType::Generic:   return "Shape";
+  }
+  return "Unknown";
+}
+
+class Drawable {
+public:
+  virtual ~Drawable() {}
+  virtual void draw() const = 0;
+};
+
+class Shape : public Drawable {
+private:
+  ShapeType type_;
+  std::string name_;
+  int x_ = 0, y_ = 0;
+  double size_ = 1.0;
+
+public:
+  Shape(ShapeType type, const std::string &name, int x, int y, double size)
+      : type_(type), name_(name), x_(x), y_(y), size_(size) {}
+
+  ShapeType type() const { return type_; }
+  const std::string &name() const { return name_; }
+  int x() const { return x_; }
+  int y() const { return y_; }
+  double size() const { return size_; }
+
+  void draw() const override {
+    std::cout << "Drawing " << toString(type_) << " '" << name_ << "' at ("
+              << x_ << "," << y_ << ") size=" << size_ << "\n";
+  }
+};
+
+//
+// =======================================================
+// 3. ON-DISK LAYOUT
+// =======================================================
+//
+
+struct SceneHeader {
+  char magic[8];             // "SHPSCN1\0"
+  std::uint32_t version;     // bump on layout change
+  std::uint32_t recordSize;  // sizeof(ShapeRecord), sanity check
+  std::uint64_t shapeCount;
+  std::uint64_t recordsOffset;
+  std::uint64_t stringsOffset;
+  std::uint64_t stringsSize;
+};
+
+struct ShapeRecord {
+  ShapeType type;
+  std::uint16_t nameLength;
+  std::uint32_t nameOffset; // into the string table
+  std::int32_t x, y;
+  double size;
+};
+
+static_assert(sizeof(SceneHeader) == 48, "SceneHeader layout changed");
+static_assert(sizeof(ShapeRecord) == 24, "ShapeRecord layout changed");
+
+constexpr char kMagic[8] = {'S', 'H', 'P', 'S', 'C', 'N', '1', '\0'};
+constexpr std::uint32_t kVersion = 1;
+
+//
+// =======================================================
+// 4. WRITER
+// =======================================================
+//
+
+// Refuses (with a message) shapes the format cannot represent rather
+// than truncating them: names over 65535 bytes (uint16 length) and
+// string tables whose offsets pass 4 GB (uint32 offset).
+bool writeScene(const std::string &path, const std::vector<Shape> &shapes) {
+  std::string strings;
+  std::unordered_map<std::string, std::uint32_t> interned; // dedupe names
+  std::vector<ShapeRecord> records;
+  records.reserve(shapes.size());
+
+  for (const auto &s : shapes) {
+    if (s.name().size() > UINT16_MAX) {
+      std::cout << "⚠️  Name of " << s.name().size()
+                << " bytes does not fit a scene file (max 65535)\n";
+      return false;
+    }
+    auto it = interned.find(s.name());
+    if (it == interned.end()) {
+      if (strings.size() > UINT32_MAX) {
+        std::cout << "⚠️  String table passes 4 GB: too many names\n";
+        return false;
+      }
+      it = interned.emplace(s.name(), std::uint32_t(strings.size())).first;
+      strings += s.name();
+    }
+    records.push_back({s.type(), std::uint16_t(s.name().size()), it->second,
+                       s.x(), s.y(), s.size()});
+  }
+
+  SceneHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.recordSize = sizeof(ShapeRecord);
+  header.shapeCount = records.size();
+  header.recordsOffset = sizeof(SceneHeader);
+  header.stringsOffset =
+      header.recordsOffset + records.size() * sizeof(ShapeRecord);
+  header.stringsSize = strings.size();
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(records.data()),
+            std::streamsize(records.size() * sizeof(ShapeRecord)));
+  out.write(strings.data(), std::streamsize(strings.size()));
+  return bool(out);
+}
+
+//
+// =======================================================
+// 5. MAPPED SCENE (zero-parse loader)
+// =======================================================
+//
+
+// A non-owning view over one record — what "a shape" is after loading
+class ShapeView : public Drawable {
+private:
+  const ShapeRecord *rec_;
+  const char *strings_;
+  std::uint64_t stringsSize_;
+
+public:
+  ShapeView(const ShapeRecord *rec, const char *strings,
+            std::uint64_t stringsSize)
+      : rec_(rec), strings_(strings), stringsSize_(stringsSize) {}
+
+  ShapeType type() const { return rec_->type; }
+  int x() const { return rec_->x; }
+  int y() const { return rec_->y; }
+  double size() const { return rec_->size; }
+
+  // No allocation: a (pointer, length) pair into the mapping. Checked
+  // here, per access: a name pointing outside the string table (a
+  // corrupt file) comes back empty instead of reading past the mapping.
+  std::string_view name() const {
+    if (rec_->nameOffset > stringsSize_ ||
+        rec_->nameLength > stringsSize_ - rec_->nameOffset) {
+      return {};
+    }
+    return {strings_ + rec_->nameOffset, rec_->nameLength};
+  }
+
+  void draw() const override {
+    std::cout << "Drawing " << toString(type()) << " '" << name() << "' at ("
+              << x() << "," << y() << ") size=" << size() << "\n";
+  }
+};
+
+class MappedScene {
+private:
+  void *base_ = MAP_FAILED;
+  std::size_t length_ = 0;
+  const SceneHeader *header_ = nullptr;
+  const ShapeRecord *records_ = nullptr;
+  const char *strings_ = nullptr;
+  std::string error_;
+
+  bool fail(const std::string &message) {
+    error_ = message;
+    close();
+    return false;
+  }
+
+public:
+  MappedScene() = default;
+  MappedScene(const MappedScene &) = delete;
+  MappedScene &operator=(const MappedScene &) = delete;
+  ~MappedScene() { close(); }
+
+  bool open(const std::string &path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return fail("cannot open " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 ||
+        std::size_t(st.st_size) < sizeof(SceneHeader)) {
+      ::close(fd);
+      return fail("file too small for a scene header");
+    }
+    length_ = std::size_t(st.st_size);
+    base_ = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+    if (base_ == MAP_FAILED) {
+      return fail("mmap failed");
+    }
+
+    const char *bytes = static_cast<const char *>(base_);
+    header_ = reinterpret_cast<const SceneHeader *>(bytes);
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 ||
+        header_->version != kVersion ||
+        header_->recordSize != sizeof(ShapeRecord)) {
+      return fail("not a version-1 scene file");
+    }
+    // Every field is attacker-controlled: compare offsets with the
+    // length before subtracting, and divide instead of multiplying
+    const SceneHeader &h = *header_;
+    if (h.recordsOffset < sizeof(SceneHeader) || h.recordsOffset > length_ ||
+        h.stringsOffset < h.recordsOffset || h.stringsOffset > length_ ||
+        h.shapeCount > (h.stringsOffset - h.recordsOffset) /
+                           sizeof(ShapeRecord) ||
+        h.stringsSize > length_ - h.stringsOffset) {
+      return fail("truncated scene file");
+    }
+    if (h.recordsOffset % alignof(ShapeRecord) != 0) { // mmap is page-aligned
+      return fail("misaligned shape records");
+    }
+    // Sequential first pass is the common case — tell the kernel
+    ::madvise(base_, length_, MADV_SEQUENTIAL);
+
+    records_ = reinterpret_cast<const ShapeRecord *>(bytes +
+                                                     header_->recordsOffset);
+    strings_ = bytes + header_->stringsOffset;
+    return true;
+  }
+
+  void close() {
+    if (base_ != MAP_FAILED) {
+      ::munmap(base_, length_);
+    }
+    base_ = MAP_FAILED;
+    length_ = 0;
+    header_ = nullptr;
+    records_ = nullptr;
+    strings_ = nullptr;
+  }
+
+  const std::string &error() const { return error_; }
+  std::size_t size() const { return header_ ? header_->shapeCount : 0; }
+
+  // Contiguous storage, usable directly by batch code
+  const ShapeRecord *records() const { return records_; }
+
+  ShapeView operator[](std::size_t i) const {
+    return ShapeView(records_ + i, strings_, header_->stringsSize);
+  }
+};
+
+//
+// =======================================================
+// 6. BENCHMARK: mmap LOAD vs CONSTRUCTORS
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+void benchmark(std::size_t count, const std::string &path) {
+  static const char *names[] = {"Circle", "Rectangle", "Triangle",
+                                "Hexagon", "Player sprite with a long name"};
+  std::vector<Shape> source;
+  source.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    source.emplace_back(ShapeType(i % 3), names[i % 5], int(i % 4096),
+                        int(i / 4096), 1.0 + double(i % 7));
+  }
+  auto start = Clock::now();
+  if (!writeScene(path, source)) {
+    std::cout << "⚠️  Could not write " << path << "\n";
+    return;
+  }
+  std::cout << "Wrote " << count << " shapes in " << millisSince(start)
+            << " ms\n";
+  source.clear();
+  source.shrink_to_fit();
+
+  // (a) mmap: open, then one pass over every record (forces page-in)
+  start = Clock::now();
+  MappedScene scene;
+  if (!scene.open(path)) {
+    std::cout << "⚠️  " << scene.error() << "\n";
+    return;
+  }
+  double openMs = millisSince(start);
+  long long checksum = 0;
+  const ShapeRecord *recs = scene.records();
+  for (std::size_t i = 0; i < scene.size(); ++i) {
+    checksum += recs[i].x + recs[i].nameLength;
+  }
+  double mmapMs = millisSince(start);
+
+  // (b) classic: build the same scene through Shape constructors
+  start = Clock::now();
+  std::vector<Shape> built;
+  built.reserve(scene.size());
+  for (std::size_t i = 0; i < scene.size(); ++i) {
+    ShapeView v = scene[i];
+    built.emplace_back(v.type(), std::string(v.name()), v.x(), v.y(),
+                       v.size());
+  }
+  long long checksum2 = 0;
+  for (const auto &s : built) {
+    checksum2 += s.x() + (long long)s.name().size();
+  }
+  double ctorMs = millisSince(start);
+
+  std::cout << "mmap open:              " << openMs << " ms\n";
+  std::cout << "mmap open + full pass:  " << mmapMs << " ms\n";
+  std::cout << "Shape constructors:     " << ctorMs << " ms\n";
+  std::cout << "Speed-up: " << ctorMs / mmapMs << "x  (checksums "
+            << (checksum == checksum2 ? "match" : "DIFFER") << ")\n";
+  std::remove(path.c_str());
+}
+
+//
+// =======================================================
+// 7. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Memory-Mapped Scene Demo ===\n\n";
+
+  std::string path = argc > 2 ? argv[2] : "/tmp/shapes.scene";
+  std::vector<Shape> shapes = {{ShapeType::Circle, "Sun", 10, 10, 4},
+                               {ShapeType::Rectangle, "House", 50, 20, 12},
+                               {ShapeType::Circle, "Sun", 90, 10, 2}};
+  writeScene(path, shapes);
+
+  MappedScene scene;
+  if (!scene.open(path)) {
+    std::cout << "⚠️  " << scene.error() << "\n";
+    return 1;
+  }
+  for (std::size_t i = 0; i < scene.size(); ++i) {
+    scene[i].draw(); // "Sun" is stored once in the string table
+  }
+  scene.close();
+
+  // A header claiming 2^61 shapes: the product would wrap to 0 bytes
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    SceneHeader header{};
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    header.shapeCount = std::uint64_t(1) << 61;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+  if (!scene.open(path)) {
+    std::cout << "⚠️  Corrupt header rejected: " << scene.error() << "\n";
+  }
+
+  // The writer refuses names the uint16 length field cannot hold
+  writeScene(path, {{ShapeType::Generic, std::string(70000, 'x'), 0, 0, 1}});
+
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 10000000;
+  std::cout << "\n=== Benchmark (" << count << " shapes) ===\n";
+  benchmark(count, path);
+
+  return 0;
+}
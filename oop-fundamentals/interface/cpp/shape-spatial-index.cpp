@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Companion to interface.cpp — viewport culling for Shape.
+//
+// Build: g++ -std=c++17 -O2 shape-spatial-index.cpp -o shape-spatial-index
+// Run:   ./shape-spatial-index [shapeCount]   (default 1,000,000)
+//
+// Ref - http://tulrich.com/geekstuff/partitioning.html (loose octrees)
+
+//
+// =======================================================
+// 1. WHY A SPATIAL INDEX?
+// =======================================================
+//
+// renderShapes() in interface.cpp calls draw() on EVERY shape.
+// With a scene of a million shapes and a screen that only shows
+// a few thousand of them, almost all of that work is wasted.
+//
+// A spatial index answers "which shapes overlap this rectangle?"
+// without looking at every shape. We use a LOOSE QUADTREE:
+//   - Each level splits the world into 2^L x 2^L cells
+//   - A cell's "loose" bounds are twice its real size
+//   - A shape lives in exactly ONE cell: the deepest level whose
+//     cell is at least as big as the shape, at the shape's centre
+//
+// Because a shape never straddles cells, move()/resize() become
+// "remove from one bucket, push into another" — O(1), no rebuild.
+
+//
+// =======================================================
+// 2. INTERFACES (same contracts as interface.cpp)
+// =======================================================
+//
+
+struct Bounds {
+  double minX, minY, maxX, maxY;
+
+  bool intersects(const Bounds &o) const {
+    return minX <= o.maxX && o.minX <= maxX && minY <= o.maxY &&
+           o.minY <= maxY;
+  }
+};
+
+class Drawable {
+public:
+  virtual ~Drawable() {}
+  virtual void draw() const = 0;
+};
+
+class Movable {
+public:
+  virtual ~Movable() {}
+  virtual void move(int x, int y) = 0;
+};
+
+class Resizable {
+public:
+  virtual ~Resizable() {}
+  virtual void resize(double factor) = 0;
+};
+
+class Shape;
+
+// Observer interface: whoever indexes shapes gets told when one changes.
+// Shape depends on this abstraction, not on the quadtree (DIP again).
+class ShapeObserver {
+public:
+  virtual ~ShapeObserver() {}
+  virtual void onShapeChanged(Shape &shape) = 0;
+};
+
+//
+// =======================================================
+// 3. SHAPE WITH BOUNDS
+// =======================================================
+//
+// Convention: a shape covers the square [x, x + size] x [y, y + size].
+
+class Shape : public Drawable, public Movable, public Resizable {
+private:
+  std::string name_;
+  int x_ = 0, y_ = 0;
+  double size_ = 1.0;
+  ShapeObserver *observer_ = nullptr;
+
+  // Bookkeeping owned by the index (which bucket / slot we live in)
+  friend class LooseQuadtree;
+  std::int32_t cell_ = -1;
+  std::int32_t slot_ = -1;
+
+public:
+  explicit Shape(const std::string &name, int x = 0, int y = 0,
+                 double size = 1.0)
+      : name_(name), x_(x), y_(y), size_(size) {}
+
+  // A copy is a new shape: same geometry, but in no index and watched
+  // by no one. Copying the slot would let two shapes fight over it.
+  Shape(const Shape &o)
+      : name_(o.name_), x_(o.x_), y_(o.y_), size_(o.size_) {}
+  Shape &operator=(const Shape &) = delete;
+
+  void setObserver(ShapeObserver *observer) { observer_ = observer; }
+
+  Bounds bounds() const {
+    return {double(x_), double(y_), x_ + size_, y_ + size_};
+  }
+
+  void draw() const override {
+    std::cout << "Drawing " << name_ << " at (" << x_ << "," << y_ << ")"
+              << " size=" << size_ << "\n";
+  }
+
+  void move(int x, int y) override {
+    x_ = x;
+    y_ = y;
+    if (observer_ != nullptr) {
+      observer_->onShapeChanged(*this);
+    }
+  }
+
+  void resize(double factor) override {
+    size_ *= factor;
+    if (observer_ != nullptr) {
+      observer_->onShapeChanged(*this);
+    }
+  }
+};
+
+//
+// =======================================================
+// 4. LOOSE QUADTREE
+// =======================================================
+//
+// All levels are stored as flat arrays of buckets (no node pointers).
+// Cell index = levelOffset[L] + cy * (1 << L) + cx.
+// Shapes outside (or bigger than) the world go into an "overflow" bucket
+// that every query scans — keeps the common case fast and the edge case
+// correct.
+
+class LooseQuadtree : public ShapeObserver {
+private:
+  double worldSize_;
+  int maxDepth_;
+  std::vector<std::size_t> levelOffset_;
+  std::vector<std::vector<Shape *>> cells_;
+  std::int32_t overflowCell_;
+  std::size_t size_ = 0;
+
+  double cellSize(int level) const { return worldSize_ / double(1 << level); }
+
+  std::int32_t cellFor(const Bounds &b) const {
+    double cx = (b.minX + b.maxX) * 0.5;
+    double cy = (b.minY + b.maxY) * 0.5;
+    double extent = std::max(b.maxX - b.minX, b.maxY - b.minY);
+    if (cx < 0 || cy < 0 || cx >= worldSize_ || cy >= worldSize_ ||
+        extent > worldSize_) {
+      return overflowCell_;
+    }
+    int level = 0;
+    while (level < maxDepth_ && extent <= cellSize(level + 1)) {
+      ++level;
+    }
+    double cs = cellSize(level);
+    int side = 1 << level;
+    int ix = std::min(side - 1, int(cx / cs));
+    int iy = std::min(side - 1, int(cy / cs));
+    return std::int32_t(levelOffset_[level] + std::size_t(iy) * side + ix);
+  }
+
+  void insertInto(Shape &shape, std::int32_t cell) {
+    auto &bucket = cells_[cell];
+    shape.cell_ = cell;
+    shape.slot_ = std::int32_t(bucket.size());
+    bucket.push_back(&shape);
+  }
+
+  void removeFrom(Shape &shape) {
+    auto &bucket = cells_[shape.cell_];
+    Shape *last = bucket.back();
+    bucket[shape.slot_] = last; // swap-and-pop keeps removal O(1)
+    last->slot_ = shape.slot_;
+    bucket.pop_back();
+    shape.cell_ = shape.slot_ = -1;
+  }
+
+  template <typename Fn>
+  void scanBucket(const std::vector<Shape *> &bucket, const Bounds &view,
+                  Fn &fn) const {
+    for (Shape *s : bucket) {
+      if (s->bounds().intersects(view)) {
+        fn(*s);
+      }
+    }
+  }
+
+public:
+  LooseQuadtree(double worldSize, int maxDepth)
+      : worldSize_(worldSize), maxDepth_(maxDepth) {
+    std::size_t total = 0;
+    for (int level = 0; level <= maxDepth_; ++level) {
+      levelOffset_.push_back(total);
+      total += std::size_t(1) << (2 * level);
+    }
+    overflowCell_ = std::int32_t(total);
+    cells_.resize(total + 1);
+  }
+
+  void insert(Shape &shape) {
+    insertInto(shape, cellFor(shape.bounds()));
+    shape.setObserver(this);
+    ++size_;
+  }
+
+  void remove(Shape &shape) {
+    removeFrom(shape);
+    shape.setObserver(nullptr);
+    --size_;
+  }
+
+  // Incremental update: only touches buckets when the home cell changes
+  void onShapeChanged(Shape &shape) override {
+    std::int32_t cell = cellFor(shape.bounds());
+    if (cell != shape.cell_) {
+      removeFrom(shape);
+      insertInto(shape, cell);
+    }
+  }
+
+  std::size_t size() const { return size_; }
+
+  // Visit every shape whose bounds overlap the viewport
+  template <typename Fn> void query(const Bounds &view, Fn fn) const {
+    for (int level = 0; level <= maxDepth_; ++level) {
+      double cs = cellSize(level);
+      int side = 1 << level;
+      // Loose cell = real cell grown by cs/2 on each side
+      int x0 = std::max(0, int((view.minX - cs * 0.5) / cs));
+      int y0 = std::max(0, int((view.minY - cs * 0.5) / cs));
+      int x1 = std::min(side - 1, int((view.maxX + cs * 0.5) / cs));
+      int y1 = std::min(side - 1, int((view.maxY + cs * 0.5) / cs));
+      for (int iy = y0; iy <= y1; ++iy) {
+        std::size_t row = levelOffset_[level] + std::size_t(iy) * side;
+        for (int ix = x0; ix <= x1; ++ix) {
+          scanBucket(cells_[row + ix], view, fn);
+        }
+      }
+    }
+    scanBucket(cells_[overflowCell_], view, fn);
+  }
+};
+
+//
+// =======================================================
+// 5. CULLING RENDERER
+// =======================================================
+//
+// Same idea as renderShapes(), but only visible shapes get draw().
+
+void renderVisible(const LooseQuadtree &index, const Bounds &viewport) {
+  std::cout << "\n--- Rendering viewport ---\n";
+  index.query(viewport, [](const Shape &s) { s.draw(); });
+}
+
+//
+// =======================================================
+// 6. BENCHMARK: QUADTREE vs LINEAR SCAN
+// =======================================================
+//
+
+using Clock = std::chrono::steady_clock;
+
+double microsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+void benchmark(std::size_t count) {
+  const double world = 65536.0;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> pos(0, int(world) - 64);
+  std::uniform_real_distribution<double> size(1.0, 64.0);
+
+  std::vector<Shape> shapes;
+  shapes.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    shapes.emplace_back("S", pos(rng), pos(rng), size(rng));
+  }
+
+  auto start = Clock::now();
+  LooseQuadtree index(world, 8);
+  for (auto &s : shapes) {
+    index.insert(s);
+  }
+  std::cout << "Build: " << count << " shapes in " << microsSince(start) / 1000
+            << " ms\n";
+
+  // Random 1920x1080 viewports
+  const int queries = 1000;
+  std::vector<Bounds> views;
+  for (int i = 0; i < queries; ++i) {
+    double x = pos(rng), y = pos(rng);
+    views.push_back({x, y, x + 1920, y + 1080});
+  }
+
+  std::size_t hitsTree = 0;
+  start = Clock::now();
+  for (const auto &v : views) {
+    index.query(v, [&](const Shape &) { ++hitsTree; });
+  }
+  double treeUs = microsSince(start) / queries;
+
+  std::size_t hitsScan = 0;
+  const int scanQueries = 20; // a full scan is slow — sample fewer
+  start = Clock::now();
+  for (int i = 0; i < scanQueries; ++i) {
+    for (const auto &s : shapes) {
+      hitsScan += s.bounds().intersects(views[i]) ? 1 : 0;
+    }
+  }
+  double scanUs = microsSince(start) / scanQueries;
+
+  std::cout << "Query (quadtree):    " << treeUs << " us/viewport, "
+            << double(hitsTree) / queries << " visible on average\n";
+  std::cout << "Query (linear scan): " << scanUs << " us/viewport, "
+            << double(hitsScan) / scanQueries << " visible on average\n";
+  std::cout << "Speed-up: " << scanUs / treeUs << "x\n";
+
+  // Incremental updates: jitter 10% of shapes, like one animation frame
+  std::uniform_int_distribution<int> jitter(-32, 32);
+  std::size_t moved = count / 10;
+  start = Clock::now();
+  for (std::size_t i = 0; i < moved; ++i) {
+    Shape &s = shapes[(i * 7919) % count];
+    Bounds b = s.bounds();
+    s.move(int(b.minX) + jitter(rng), int(b.minY) + jitter(rng));
+  }
+  std::cout << "Incremental move(): " << microsSince(start) * 1000 / moved
+            << " ns/shape (" << moved << " moves)\n";
+}
+
+//
+// =======================================================
+// 7. DEMONSTRATION
+// =======================================================
+//
+
+int main(int argc, char **argv) {
+  std::cout << "=== Spatial Index (Loose Quadtree) Demo ===\n";
+
+  Shape a("Triangle", 10, 10, 5);
+  Shape b("Square", 500, 500, 20);
+  Shape c("Hexagon", 90, 40, 8);
+
+  LooseQuadtree index(1024.0, 6);
+  index.insert(a);
+  index.insert(b);
+  index.insert(c);
+
+  Bounds viewport{0, 0, 100, 100};
+  renderVisible(index, viewport); // Triangle + Hexagon
+
+  b.move(50, 50); // index updates itself through ShapeObserver
+  renderVisible(index, viewport); // now Square too
+
+  c.resize(0.5);
+  a.move(2000, 2000); // leaves the world -> overflow bucket
+  renderVisible(index, viewport);
+
+  std::size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  std::cout << "\n=== Benchmark (" << count << " shapes) ===\n";
+  benchmark(count);
+
+  return 0;
+}